@@ -0,0 +1,23 @@
+﻿using UnrealBuildTool;
+
+public class GameplayExperiencesInsights : ModuleRules
+{
+    public GameplayExperiencesInsights(ReadOnlyTargetRules Target) : base(Target)
+    {
+        PublicDependencyModuleNames.AddRange(
+            new string[]
+            {
+                "Core",
+                "TraceServices",
+            }
+        );
+
+        PrivateDependencyModuleNames.AddRange(
+            new string[]
+            {
+                "TraceAnalysis",
+                "GameplayExperiencesRuntime",
+            }
+        );
+    }
+}
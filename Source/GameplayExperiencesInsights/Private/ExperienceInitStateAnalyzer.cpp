@@ -0,0 +1,55 @@
+// Copyright © 2024 Playton. All Rights Reserved.
+
+
+#include "ExperienceInitStateAnalyzer.h"
+
+#include "ExperienceInitStateProviderImpl.h"
+#include "TraceServices/Model/AnalysisSession.h"
+
+FExperienceInitStateAnalyzer::FExperienceInitStateAnalyzer(TraceServices::IAnalysisSession& InSession, FExperienceInitStateProvider& InProvider)
+	: Session(InSession)
+	, Provider(InProvider)
+{
+}
+
+void FExperienceInitStateAnalyzer::OnAnalysisBegin(const FOnAnalysisContext& Context)
+{
+	FInterfaceBuilder& Builder = Context.InterfaceBuilder;
+
+	Builder.RouteEvent(RouteId_InitStateName, "GameplayExperiences", "InitStateName");
+	Builder.RouteEvent(RouteId_InitStateTransition, "GameplayExperiences", "InitStateTransition");
+}
+
+bool FExperienceInitStateAnalyzer::OnEvent(uint16 RouteId, EStyle Style, const FOnEventContext& Context)
+{
+	TraceServices::FAnalysisSessionEditScope _(Session);
+
+	const FEventData& EventData = Context.EventData;
+
+	switch (RouteId)
+	{
+	case RouteId_InitStateName:
+	{
+		FString Name;
+		EventData.GetString("Name", Name);
+		Provider.AddName(EventData.GetValue<uint32>("Id"), Name);
+		break;
+	}
+
+	case RouteId_InitStateTransition:
+	{
+		FExperienceInitStateTransitionEvent Transition;
+		Transition.Time = Context.EventTime.AsSeconds(EventData.GetValue<uint64>("Cycle"));
+		Transition.PawnId = EventData.GetValue<uint64>("PawnId");
+		Transition.PawnClassName = Provider.GetName(EventData.GetValue<uint32>("PawnClassId"));
+		Transition.FeatureName = Provider.GetName(EventData.GetValue<uint32>("FeatureId"));
+		Transition.FromState = Provider.GetName(EventData.GetValue<uint32>("FromStateId"));
+		Transition.ToState = Provider.GetName(EventData.GetValue<uint32>("ToStateId"));
+		Transition.Reason = static_cast<EExperienceInitStateReason>(EventData.GetValue<uint8>("Reason"));
+		Provider.AddTransition(Transition);
+		break;
+	}
+	}
+
+	return true;
+}
@@ -0,0 +1,31 @@
+// Copyright © 2024 Playton. All Rights Reserved.
+
+#pragma once
+
+#include "Trace/Analyzer.h"
+
+class FExperienceInitStateProvider;
+
+namespace TraceServices { class IAnalysisSession; }
+
+/** Decodes the events of the ExperienceInitState trace channel (GameplayExperiences logger) into the init state provider. */
+class FExperienceInitStateAnalyzer : public UE::Trace::IAnalyzer
+{
+public:
+	FExperienceInitStateAnalyzer(TraceServices::IAnalysisSession& InSession, FExperienceInitStateProvider& InProvider);
+
+	//~ Begin IAnalyzer Interface
+	virtual void OnAnalysisBegin(const FOnAnalysisContext& Context) override;
+	virtual bool OnEvent(uint16 RouteId, EStyle Style, const FOnEventContext& Context) override;
+	//~ End IAnalyzer Interface
+
+private:
+	enum : uint16
+	{
+		RouteId_InitStateName,
+		RouteId_InitStateTransition,
+	};
+
+	TraceServices::IAnalysisSession& Session;
+	FExperienceInitStateProvider& Provider;
+};
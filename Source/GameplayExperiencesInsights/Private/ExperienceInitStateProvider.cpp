@@ -0,0 +1,78 @@
+// Copyright © 2024 Playton. All Rights Reserved.
+
+
+#include "ExperienceInitStateProviderImpl.h"
+
+#include "Algo/BinarySearch.h"
+
+const FName FExperienceInitStateProvider::ProviderName("ExperienceInitStateProvider");
+
+FExperienceInitStateProvider::FExperienceInitStateProvider(TraceServices::IAnalysisSession& InSession)
+	: Session(InSession)
+{
+}
+
+int32 FExperienceInitStateProvider::GetNumTransitions() const
+{
+	Session.ReadAccessCheck();
+
+	return Transitions.Num();
+}
+
+void FExperienceInitStateProvider::EnumerateTransitions(double StartTime, double EndTime, TFunctionRef<bool(const FExperienceInitStateTransitionEvent&)> Callback) const
+{
+	Session.ReadAccessCheck();
+
+	const int32 FirstIndex = Algo::LowerBoundBy(Transitions, StartTime, &FExperienceInitStateTransitionEvent::Time);
+	for (int32 Index = FirstIndex; Index < Transitions.Num() && Transitions[Index].Time <= EndTime; ++Index)
+	{
+		if (!Callback(Transitions[Index]))
+		{
+			return;
+		}
+	}
+}
+
+void FExperienceInitStateProvider::EnumeratePawnTransitions(uint64 PawnId, TFunctionRef<bool(const FExperienceInitStateTransitionEvent&)> Callback) const
+{
+	Session.ReadAccessCheck();
+
+	if (const TArray<int32>* Indices = TransitionsByPawn.Find(PawnId))
+	{
+		for (const int32 Index : *Indices)
+		{
+			if (!Callback(Transitions[Index]))
+			{
+				return;
+			}
+		}
+	}
+}
+
+void FExperienceInitStateProvider::AddName(uint32 Id, FStringView Name)
+{
+	Session.WriteAccessCheck();
+
+	Names.Add(Id, Session.StoreString(Name));
+}
+
+const TCHAR* FExperienceInitStateProvider::GetName(uint32 Id) const
+{
+	const TCHAR* const* Name = Names.Find(Id);
+	return Name ? *Name : TEXT("");
+}
+
+void FExperienceInitStateProvider::AddTransition(const FExperienceInitStateTransitionEvent& Transition)
+{
+	Session.WriteAccessCheck();
+
+	const int32 Index = Transitions.Add(Transition);
+	TransitionsByPawn.FindOrAdd(Transition.PawnId).Add(Index);
+
+	Session.UpdateDurationSeconds(Transition.Time);
+}
+
+const IExperienceInitStateProvider* ReadExperienceInitStateProvider(const TraceServices::IAnalysisSession& Session)
+{
+	return Session.ReadProvider<IExperienceInitStateProvider>(FExperienceInitStateProvider::ProviderName);
+}
@@ -0,0 +1,40 @@
+// Copyright © 2024 Playton. All Rights Reserved.
+
+#pragma once
+
+#include "ExperienceInitStateProvider.h"
+
+/** Stores the transitions decoded by FExperienceInitStateAnalyzer. */
+class FExperienceInitStateProvider : public IExperienceInitStateProvider
+{
+public:
+	static const FName ProviderName;
+
+	explicit FExperienceInitStateProvider(TraceServices::IAnalysisSession& InSession);
+
+	//~ Begin IExperienceInitStateProvider Interface
+	virtual int32 GetNumTransitions() const override;
+	virtual void EnumerateTransitions(double StartTime, double EndTime, TFunctionRef<bool(const FExperienceInitStateTransitionEvent&)> Callback) const override;
+	virtual void EnumeratePawnTransitions(uint64 PawnId, TFunctionRef<bool(const FExperienceInitStateTransitionEvent&)> Callback) const override;
+	//~ End IExperienceInitStateProvider Interface
+
+	/** Declares the name behind a trace id. */
+	void AddName(uint32 Id, FStringView Name);
+
+	/** Returns the name declared for the trace id, or an empty string if it hasn't been declared. */
+	const TCHAR* GetName(uint32 Id) const;
+
+	/** Adds a transition. Transitions are traced from the game thread, so they arrive in time order. */
+	void AddTransition(const FExperienceInitStateTransitionEvent& Transition);
+
+private:
+	TraceServices::IAnalysisSession& Session;
+
+	/** Names declared by the trace, stored in the session's string store. */
+	TMap<uint32, const TCHAR*> Names;
+
+	TArray<FExperienceInitStateTransitionEvent> Transitions;
+
+	/** Indices into Transitions for each pawn. */
+	TMap<uint64, TArray<int32>> TransitionsByPawn;
+};
@@ -0,0 +1,53 @@
+// Copyright © 2024 Playton. All Rights Reserved.
+
+#include "ExperienceInitStateAnalyzer.h"
+#include "ExperienceInitStateProviderImpl.h"
+#include "Features/IModularFeatures.h"
+#include "Modules/ModuleManager.h"
+#include "TraceServices/ModuleService.h"
+
+/** Adds the init state analyzer and provider to every analysis session, so Insights can decode the ExperienceInitState channel. */
+class FExperienceInitStateTraceModule : public TraceServices::IModule
+{
+public:
+	//~ Begin TraceServices::IModule Interface
+	virtual void GetModuleInfo(TraceServices::FModuleInfo& OutModuleInfo) override
+	{
+		OutModuleInfo.Name = TEXT("ExperienceInitStateTrace");
+		OutModuleInfo.DisplayName = TEXT("Experience Init States");
+	}
+
+	virtual void OnAnalysisBegin(TraceServices::IAnalysisSession& Session) override
+	{
+		TSharedPtr<FExperienceInitStateProvider> Provider = MakeShared<FExperienceInitStateProvider>(Session);
+		Session.AddProvider(FExperienceInitStateProvider::ProviderName, Provider);
+		Session.AddAnalyzer(new FExperienceInitStateAnalyzer(Session, *Provider));
+	}
+
+	virtual void GetLoggers(TArray<const TCHAR*>& OutLoggers) override
+	{
+		OutLoggers.Add(TEXT("GameplayExperiences"));
+	}
+
+	virtual void GenerateReports(const TraceServices::IAnalysisSession& Session, const TCHAR* CmdLine, const TCHAR* OutputDirectory) override {}
+
+	virtual const TCHAR* GetCommandLineArgument() override { return TEXT("experienceinitstatetrace"); }
+	//~ End TraceServices::IModule Interface
+};
+
+class FGameplayExperiencesInsightsModule : public FDefaultModuleImpl
+{
+	virtual void StartupModule() override
+	{
+		IModularFeatures::Get().RegisterModularFeature(TraceServices::ModuleFeatureName, &TraceModule);
+	}
+
+	virtual void ShutdownModule() override
+	{
+		IModularFeatures::Get().UnregisterModularFeature(TraceServices::ModuleFeatureName, &TraceModule);
+	}
+
+	FExperienceInitStateTraceModule TraceModule;
+};
+
+IMPLEMENT_MODULE(FGameplayExperiencesInsightsModule, GameplayExperiencesInsights)
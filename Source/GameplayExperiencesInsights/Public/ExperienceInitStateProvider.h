@@ -0,0 +1,45 @@
+// Copyright © 2024 Playton. All Rights Reserved.
+
+#pragma once
+
+#include "Components/ExperienceInitStateTrace.h"
+#include "TraceServices/Model/AnalysisSession.h"
+
+/** An init state transition of a pawn feature, or a refused one, decoded from the ExperienceInitState trace channel. */
+struct FExperienceInitStateTransitionEvent
+{
+	/** Time of the event in seconds, relative to the start of the session. */
+	double Time = 0.0;
+
+	/** Address of the pawn, only meaningful to tell pawns apart. */
+	uint64 PawnId = 0;
+
+	const TCHAR* PawnClassName = TEXT("");
+	const TCHAR* FeatureName = TEXT("");
+	const TCHAR* FromState = TEXT("");
+	const TCHAR* ToState = TEXT("");
+
+	EExperienceInitStateReason Reason = EExperienceInitStateReason::Transitioned;
+};
+
+/**
+ * Read access to the init state transitions of an analysis session.
+ * Access it with the session's read scope held, through ReadExperienceInitStateProvider.
+ */
+class GAMEPLAYEXPERIENCESINSIGHTS_API IExperienceInitStateProvider : public TraceServices::IProvider
+{
+public:
+	virtual ~IExperienceInitStateProvider() = default;
+
+	/** Returns the number of transitions in the session. */
+	virtual int32 GetNumTransitions() const = 0;
+
+	/** Calls the callback for every transition between StartTime and EndTime, in time order. Return false from the callback to stop. */
+	virtual void EnumerateTransitions(double StartTime, double EndTime, TFunctionRef<bool(const FExperienceInitStateTransitionEvent&)> Callback) const = 0;
+
+	/** Calls the callback for every transition of a single pawn, in time order. Return false from the callback to stop. */
+	virtual void EnumeratePawnTransitions(uint64 PawnId, TFunctionRef<bool(const FExperienceInitStateTransitionEvent&)> Callback) const = 0;
+};
+
+/** Returns the init state provider of the session, or nullptr if the session has none. */
+GAMEPLAYEXPERIENCESINSIGHTS_API const IExperienceInitStateProvider* ReadExperienceInitStateProvider(const TraceServices::IAnalysisSession& Session);
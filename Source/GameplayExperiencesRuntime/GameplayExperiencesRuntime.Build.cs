@@ -26,6 +26,7 @@ public class GameplayExperiencesRuntime : ModuleRules
         {
             "CoreUObject", 
             "NetCore",
+            "AIModule",
         });
     }
 }
\ No newline at end of file
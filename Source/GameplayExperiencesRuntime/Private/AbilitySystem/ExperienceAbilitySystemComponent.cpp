@@ -0,0 +1,113 @@
+// Copyright © 2024 Playton. All Rights Reserved.
+
+
+#include "AbilitySystem/ExperienceAbilitySystemComponent.h"
+
+#include "GameplayExperiencesStats.h"
+#include "ModularAbilityTagRelationshipMapping.h"
+#include "UObject/ObjectKey.h"
+
+#include UE_INLINE_GENERATED_CPP_BY_NAME(ExperienceAbilitySystemComponent)
+
+DECLARE_DWORD_COUNTER_STAT(TEXT("Compiled Tag Relationships"), STAT_ExperienceCompiledTagRelationships, STATGROUP_GameplayExperiences);
+
+namespace ExperienceTagRelationships
+{
+	static TMap<TObjectKey<UModularAbilityTagRelationshipMapping>, TUniquePtr<FExperienceCompiledTagRelationships>> CompiledMappings;
+
+	/** Containers compare equal regardless of the order of their tags, so the hash can't depend on it either. */
+	static uint32 HashTags(const FGameplayTagContainer& Tags)
+	{
+		uint32 Hash = Tags.Num();
+		for (const FGameplayTag& Tag : Tags)
+		{
+			Hash += MurmurFinalize32(GetTypeHash(Tag));
+		}
+		return Hash;
+	}
+}
+
+//////////////////////////////////////////////////////////////////////////
+/// FExperienceCompiledTagRelationships
+
+FExperienceCompiledTagRelationships& FExperienceCompiledTagRelationships::Get(const UModularAbilityTagRelationshipMapping* Mapping)
+{
+	check(Mapping);
+
+	TUniquePtr<FExperienceCompiledTagRelationships>& Compiled = ExperienceTagRelationships::CompiledMappings.FindOrAdd(Mapping);
+	if (!Compiled.IsValid())
+	{
+		Compiled = MakeUnique<FExperienceCompiledTagRelationships>();
+		Compiled->Mapping = Mapping;
+	}
+
+	return *Compiled;
+}
+
+void FExperienceCompiledTagRelationships::Reset()
+{
+	ExperienceTagRelationships::CompiledMappings.Reset();
+}
+
+const FExperienceCompiledTagRelationships::FEntry& FExperienceCompiledTagRelationships::FindOrCompile(const FGameplayTagContainer& AbilityTags)
+{
+	const uint32 Hash = ExperienceTagRelationships::HashTags(AbilityTags);
+
+	for (TMultiMap<uint32, FEntry>::TConstKeyIterator It(Entries, Hash); It; ++It)
+	{
+		if (It.Value().AbilityTags == AbilityTags)
+		{
+			return It.Value();
+		}
+	}
+
+	FEntry& Entry = Entries.Add(Hash);
+	Entry.AbilityTags = AbilityTags;
+
+	if (const UModularAbilityTagRelationshipMapping* MappingPtr = Mapping.Get())
+	{
+		MappingPtr->GetAbilityTagsToBlockAndCancel(AbilityTags, &Entry.TagsToBlock, &Entry.TagsToCancel);
+		MappingPtr->GetRequiredAndBlockedActivationTags(AbilityTags, &Entry.ActivationRequired, &Entry.ActivationBlocked);
+	}
+
+	INC_DWORD_STAT(STAT_ExperienceCompiledTagRelationships);
+	return Entry;
+}
+
+//////////////////////////////////////////////////////////////////////////
+/// UExperienceAbilitySystemComponent
+
+UExperienceAbilitySystemComponent::UExperienceAbilitySystemComponent(const FObjectInitializer& ObjectInitializer)
+	: Super(ObjectInitializer)
+{
+}
+
+void UExperienceAbilitySystemComponent::GetAdditionalActivationTagRequirements(const FGameplayTagContainer& AbilityTags, FGameplayTagContainer& OutActivationRequired, FGameplayTagContainer& OutActivationBlocked) const
+{
+	// Same as the modular implementation, without walking the mapping on every activation check
+	if (TagRelationshipMapping)
+	{
+		const FExperienceCompiledTagRelationships::FEntry& Entry = FExperienceCompiledTagRelationships::Get(TagRelationshipMapping).FindOrCompile(AbilityTags);
+		OutActivationRequired.AppendTags(Entry.ActivationRequired);
+		OutActivationBlocked.AppendTags(Entry.ActivationBlocked);
+	}
+}
+
+void UExperienceAbilitySystemComponent::ApplyAbilityBlockAndCancelTags(const FGameplayTagContainer& AbilityTags, UGameplayAbility* RequestingAbility, bool bEnableBlockTags, const FGameplayTagContainer& BlockTags, bool bExecuteCancelTags, const FGameplayTagContainer& CancelTags)
+{
+	if (!TagRelationshipMapping)
+	{
+		Super::ApplyAbilityBlockAndCancelTags(AbilityTags, RequestingAbility, bEnableBlockTags, BlockTags, bExecuteCancelTags, CancelTags);
+		return;
+	}
+
+	const FExperienceCompiledTagRelationships::FEntry& Entry = FExperienceCompiledTagRelationships::Get(TagRelationshipMapping).FindOrCompile(AbilityTags);
+
+	FGameplayTagContainer ModifiedBlockTags = BlockTags;
+	FGameplayTagContainer ModifiedCancelTags = CancelTags;
+	ModifiedBlockTags.AppendTags(Entry.TagsToBlock);
+	ModifiedCancelTags.AppendTags(Entry.TagsToCancel);
+
+	// Skip the modular implementation, it would walk the mapping again
+	UAbilitySystemComponent::ApplyAbilityBlockAndCancelTags(AbilityTags, RequestingAbility, bEnableBlockTags, ModifiedBlockTags, bExecuteCancelTags, ModifiedCancelTags);
+}
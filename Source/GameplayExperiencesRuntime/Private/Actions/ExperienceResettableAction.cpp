@@ -0,0 +1,6 @@
+// Copyright © 2024 Playton. All Rights Reserved.
+
+
+#include "Actions/ExperienceResettableAction.h"
+
+#include UE_INLINE_GENERATED_CPP_BY_NAME(ExperienceResettableAction)
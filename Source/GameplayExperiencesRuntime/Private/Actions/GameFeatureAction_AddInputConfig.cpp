@@ -0,0 +1,60 @@
+// Copyright © 2024 Playton. All Rights Reserved.
+
+
+#include "Actions/GameFeatureAction_AddInputConfig.h"
+
+#include "GameFeaturesSubsystemSettings.h"
+
+#if WITH_EDITOR
+#include "GameFeatureData.h"
+#include "Misc/DataValidation.h"
+#endif
+
+#include UE_INLINE_GENERATED_CPP_BY_NAME(GameFeatureAction_AddInputConfig)
+
+#define LOCTEXT_NAMESPACE "GameplayExperiences"
+
+#if WITH_EDITORONLY_DATA
+void UGameFeatureAction_AddInputConfig::AddAdditionalAssetBundleData(FAssetBundleData& AssetBundleData)
+{
+	// The contributed configs are applied along with the one of the pawn data, stream them with the experience as well
+	// Their mapping contexts are streamed by the hero component once the configs are in, see UExperienceHeroComponent::LoadInputMappings
+	for (const FExperienceInputConfigEntry& Entry : InputConfigs)
+	{
+		if (!Entry.InputConfig.IsNull())
+		{
+			AssetBundleData.AddBundleAsset(UGameFeaturesSubsystemSettings::LoadStateClient, Entry.InputConfig.ToSoftObjectPath().GetAssetPath());
+		}
+	}
+}
+#endif
+
+#if WITH_EDITOR
+EDataValidationResult UGameFeatureAction_AddInputConfig::IsDataValid(FDataValidationContext& Context) const
+{
+	EDataValidationResult Result = Super::IsDataValid(Context);
+
+	// Tables are only built from the actions of the loaded experience, the game feature data of a plugin isn't looked at
+	if (GetTypedOuter<UGameFeatureData>() != nullptr)
+	{
+		Result = EDataValidationResult::Invalid;
+		Context.AddError(LOCTEXT("InputConfigActionOutsideExperience", "Add Input Config only takes effect in the actions of an experience or of an action set, not in the game feature data of a plugin"));
+	}
+
+	int32 EntryIndex = 0;
+	for (const FExperienceInputConfigEntry& Entry : InputConfigs)
+	{
+		if (Entry.InputConfig.IsNull())
+		{
+			Result = EDataValidationResult::Invalid;
+			Context.AddError(FText::Format(LOCTEXT("InputConfigEntryIsNull", "Null InputConfig at index {0} in InputConfigs"), FText::AsNumber(EntryIndex)));
+		}
+
+		++EntryIndex;
+	}
+
+	return Result;
+}
+#endif
+
+#undef LOCTEXT_NAMESPACE
@@ -5,15 +5,21 @@
 
 #include "AbilitySystemGlobals.h"
 #include "EnhancedInputSubsystems.h"
+#include "Engine/AssetManager.h"
 #include "ExperienceGameFrameworkCallouts.h"
 #include "ExperienceManagerSubsystem.h"
 #include "GameplayExperiencesLog.h"
 #include "InputMappingContext.h"
+#include "Components/ExperienceInitStateMetrics.h"
+#include "Components/ExperienceInitStateTrace.h"
+#include "Components/ExperienceManagerComponent.h"
 #include "Components/ExperiencePawnExtensionComponent.h"
 #include "Components/GameFrameworkComponentManager.h"
 #include "GameFramework/ExperiencePlayerState.h"
 #include "GameFramework/PlayerState.h"
 #include "Misc/UObjectToken.h"
+#include "Input/ExperienceInputConfigTable.h"
+#include "Input/ExperienceInputMappingSubsystem.h"
 #include "Input/InputConfig.h"
 #include "UserSettings/EnhancedInputUserSettings.h"
 
@@ -31,21 +37,26 @@ bool UExperienceHeroComponent::CanChangeInitState(
 	UGameFrameworkComponentManager* Manager, FGameplayTag CurrentState, FGameplayTag DesiredState) const
 {
 	check(Manager);
+
+	const int32 Stage = UExperienceManagerSubsystem::Get()->GetInitStateChain().GetTransitionStage(CurrentState, DesiredState);
+	return Stage != INDEX_NONE && CanEnterInitStage(Manager, Stage);
+}
+
+bool UExperienceHeroComponent::CanEnterInitStage(UGameFrameworkComponentManager* Manager, int32 Stage) const
+{
 	APawn* Pawn = GetPawn<APawn>();
-	const UExperienceManagerSubsystem* ExpMgr = UExperienceManagerSubsystem::Get();
 
+	switch (Stage)
+	{
 	// None -> Spawned
-	if (!CurrentState.IsValid() && DesiredState == ExpMgr->GetTag_Spawned())
+	case FExperienceInitStateChain::SpawnedStage:
 	{
 		// As long as we're on a valid pawn, we count as spawned
-		if (IsValid(Pawn))
-		{
-			return true;
-		}
+		return IsValid(Pawn);
 	}
 
 	// Spawned -> Available
-	else if (CurrentState == ExpMgr->GetTag_Spawned() && DesiredState == ExpMgr->GetTag_Available())
+	case FExperienceInitStateChain::AvailableStage:
 	{
 		// The player state is required
 		if (!GetPlayerState<APlayerState>())
@@ -53,6 +64,12 @@ bool UExperienceHeroComponent::CanChangeInitState(
 			return false;
 		}
 
+		// Bots have no input or local player to wait for, the player state is all they need
+		if (Pawn->IsBotControlled())
+		{
+			return true;
+		}
+
 		// Check for simulated proxies
 		if (Pawn->GetLocalRole() != ROLE_SimulatedProxy)
 		{
@@ -86,28 +103,34 @@ bool UExperienceHeroComponent::CanChangeInitState(
 	}
 
 	// Available -> Initialized
-	else if (CurrentState == ExpMgr->GetTag_Available() && DesiredState == ExpMgr->GetTag_Initialized())
+	case FExperienceInitStateChain::InitializedStage:
 	{
 		// Wait for player state and extension component
 		APlayerState* PS = GetPlayerState<APlayerState>();
-		return PS && Manager->HasFeatureReachedInitState(Pawn, UExperiencePawnExtensionComponent::NAME_ActorFeatureName, ExpMgr->GetTag_Initialized());
+		if (!PS || !Manager->HasFeatureReachedInitState(Pawn, UExperiencePawnExtensionComponent::NAME_ActorFeatureName, UExperienceManagerSubsystem::Get()->GetTag_Initialized()))
+		{
+			return false;
+		}
+
+		// Local players initialize their input, wait for the mapping contexts rather than loading them synchronously
+		return !IsLocalPlayerPawn() || AreInputMappingsLoaded();
 	}
 
-	// Initialized -> Ready
-	else if (CurrentState == ExpMgr->GetTag_Initialized() && DesiredState == ExpMgr->GetTag_Ready())
-	{
+	// Initialized -> project specific stages -> Ready
+	default:
 		return true;
 	}
-
-	return false;
 }
 
 void UExperienceHeroComponent::HandleChangeInitState(
 	UGameFrameworkComponentManager* Manager, FGameplayTag CurrentState, FGameplayTag DesiredState)
 {
-	const UExperienceManagerSubsystem* ExpMgr = UExperienceManagerSubsystem::Get();
+	TRACE_EXPERIENCE_INIT_STATE(GetOwner(), NAME_ActorFeatureName, CurrentState, DesiredState, EExperienceInitStateReason::Transitioned);
+
+	FExperienceInitStateMetrics::RecordStage(GetOwner(), NAME_ActorFeatureName, CurrentState, DesiredState, InitStateEnterTime);
+	InitStateEnterTime = FPlatformTime::Seconds();
 
-	if (CurrentState == ExpMgr->GetTag_Available() && DesiredState == ExpMgr->GetTag_Initialized())
+	if (UExperienceManagerSubsystem::Get()->GetInitStateChain().GetStage(DesiredState) == FExperienceInitStateChain::InitializedStage)
 	{
 		const APawn* Pawn = GetPawn<APawn>();
 		AExperiencePlayerState* PS = GetPlayerState<AExperiencePlayerState>();
@@ -124,7 +147,8 @@ void UExperienceHeroComponent::HandleChangeInitState(
 			PawnExtComp->InitializeAbilitySystem(UAbilitySystemGlobals::GetAbilitySystemComponentFromActor(PS), PS);
 		}
 
-		if (Pawn->InputComponent != nullptr)
+		// Bots skip input entirely
+		if (Pawn->InputComponent != nullptr && !Pawn->IsBotControlled())
 		{
 			InitializePlayerInput(Pawn->InputComponent);
 		}
@@ -147,7 +171,310 @@ void UExperienceHeroComponent::OnActorInitStateChanged(const FActorInitStateChan
 
 void UExperienceHeroComponent::CheckDefaultInitialization()
 {
-	ContinueInitStateChain(UExperienceManagerSubsystem::Get()->StateChain);
+	if (IsLocalPlayerPawn())
+	{
+		LoadInputMappings();
+		LoadDeviceInputMappings();
+	}
+
+	ContinueInitStateChain(UExperienceManagerSubsystem::Get()->GetInitStateChain().GetStates());
+}
+
+bool UExperienceHeroComponent::IsLocalPlayerPawn() const
+{
+	const APawn* Pawn = GetPawn<APawn>();
+	return Pawn && Pawn->IsLocallyControlled() && !Pawn->IsBotControlled() && GetController<APlayerController>() != nullptr;
+}
+
+TSharedPtr<const FExperienceInputConfigTable> UExperienceHeroComponent::FindInputConfigTable(const UExperiencePawnData* PawnData) const
+{
+	const UExperienceManagerComponent* ExperienceComponent = UExperienceManagerComponent::Get(this);
+	return ExperienceComponent ? ExperienceComponent->GetInputConfigTable(PawnData) : nullptr;
+}
+
+void UExperienceHeroComponent::GatherInputMappings(const UExperiencePawnData* PawnData, TArray<FInputMappingContextAndPriority>& OutMappings, bool bIncludeDeviceMappings) const
+{
+	OutMappings.Append(DefaultInputMappings);
+
+	if (bIncludeDeviceMappings)
+	{
+		GatherDeviceInputMappings(OutMappings);
+	}
+
+	if (const TSharedPtr<const FExperienceInputConfigTable> Table = FindInputConfigTable(PawnData))
+	{
+		OutMappings.Append(Table->GetInputMappings());
+	}
+	else if (const UInputConfig* InputConfig = PawnData ? PawnData->InputConfig.Get() : nullptr)
+	{
+		OutMappings.Append(InputConfig->InputMappings);
+	}
+}
+
+void UExperienceHeroComponent::GatherDeviceInputMappings(TArray<FInputMappingContextAndPriority>& OutMappings) const
+{
+	const EHardwareDevicePrimaryType DeviceType = ActiveDeviceType != EHardwareDevicePrimaryType::Unspecified ? ActiveDeviceType : GetCurrentDeviceType();
+
+	for (const FExperienceDeviceInputMapping& DeviceMapping : DeviceInputMappings)
+	{
+		if (DeviceMapping.DeviceType == EHardwareDevicePrimaryType::Unspecified || DeviceMapping.DeviceType == DeviceType)
+		{
+			OutMappings.Add(DeviceMapping.Mapping);
+		}
+	}
+}
+
+EHardwareDevicePrimaryType UExperienceHeroComponent::GetCurrentDeviceType() const
+{
+	const APlayerController* PC = GetController<APlayerController>();
+	const UInputDeviceSubsystem* DeviceSubsystem = UInputDeviceSubsystem::Get();
+	if (PC && DeviceSubsystem)
+	{
+		const FHardwareDeviceIdentifier Device = DeviceSubsystem->GetMostRecentlyUsedHardwareDevice(PC->GetPlatformUserId());
+		if (Device.PrimaryDeviceType != EHardwareDevicePrimaryType::Unspecified)
+		{
+			return Device.PrimaryDeviceType;
+		}
+	}
+
+	return DefaultDeviceType;
+}
+
+bool UExperienceHeroComponent::AreInputMappingsLoaded() const
+{
+	const UExperiencePawnExtensionComponent* PawnExtComp = UExperiencePawnExtensionComponent::FindPawnExtensionComponent(GetOwner());
+	const UExperiencePawnData* PawnData = PawnExtComp ? PawnExtComp->GetPawnData() : nullptr;
+
+	// Its mapping contexts aren't known before the input config is in
+	if (PawnData && IsInputAssetPending(PawnData->InputConfig.ToSoftObjectPath()))
+	{
+		return false;
+	}
+
+	TArray<FInputMappingContextAndPriority> Mappings;
+	GatherInputMappings(PawnData, Mappings);
+
+	for (const FInputMappingContextAndPriority& Mapping : Mappings)
+	{
+		if (IsInputAssetPending(Mapping.InputMapping.ToSoftObjectPath()))
+		{
+			return false;
+		}
+	}
+
+	return true;
+}
+
+bool UExperienceHeroComponent::IsInputAssetPending(const FSoftObjectPath& Path) const
+{
+	return !Path.IsNull() && Path.ResolveObject() == nullptr && !FailedInputAssetPaths.Contains(Path);
+}
+
+void UExperienceHeroComponent::LoadInputMappings()
+{
+	if (InputMappingsLoadHandle.IsValid() && InputMappingsLoadHandle->IsLoadingInProgress())
+	{
+		return;
+	}
+
+	const UExperiencePawnExtensionComponent* PawnExtComp = UExperiencePawnExtensionComponent::FindPawnExtensionComponent(GetOwner());
+	const UExperiencePawnData* PawnData = PawnExtComp ? PawnExtComp->GetPawnData() : nullptr;
+
+	// Device input mappings are kept loaded by their own handle, so they can be released on device change
+	TArray<FInputMappingContextAndPriority> Mappings;
+	GatherInputMappings(PawnData, Mappings, false);
+
+	// Usually streamed with the client bundle of the experience already
+	// The mapping contexts of the input config are gathered once it has loaded, on the next pass
+	TArray<FSoftObjectPath> PathsToLoad;
+	if (PawnData && IsInputAssetPending(PawnData->InputConfig.ToSoftObjectPath()))
+	{
+		PathsToLoad.Add(PawnData->InputConfig.ToSoftObjectPath());
+	}
+
+	for (const FInputMappingContextAndPriority& Mapping : Mappings)
+	{
+		if (IsInputAssetPending(Mapping.InputMapping.ToSoftObjectPath()))
+		{
+			PathsToLoad.AddUnique(Mapping.InputMapping.ToSoftObjectPath());
+		}
+	}
+
+	if (PathsToLoad.Num() == 0)
+	{
+		InputMappingsLoadHandle.Reset();
+		return;
+	}
+
+	EXPERIENCE_LOG(Verbose, TEXT("Streaming %d input mapping contexts for [%s]"), PathsToLoad.Num(), *GetNameSafe(GetOwner()));
+
+	InputMappingsLoadHandle = UAssetManager::GetStreamableManager().RequestAsyncLoad(PathsToLoad,
+		FStreamableDelegate::CreateUObject(this, &ThisClass::OnInputMappingsLoaded, PathsToLoad), FStreamableManager::AsyncLoadHighPriority);
+
+	// Nothing could be requested at all, don't wait for a callback that never comes
+	if (!InputMappingsLoadHandle.IsValid())
+	{
+		OnInputMappingsLoaded(PathsToLoad);
+	}
+}
+
+void UExperienceHeroComponent::OnInputMappingsLoaded(TArray<FSoftObjectPath> RequestedPaths)
+{
+	NoteFailedInputAssets(RequestedPaths);
+	CheckDefaultInitialization();
+}
+
+void UExperienceHeroComponent::NoteFailedInputAssets(const TArray<FSoftObjectPath>& RequestedPaths)
+{
+	// A finished load is final, whatever didn't resolve now is a broken reference and won't resolve by asking again
+	for (const FSoftObjectPath& Path : RequestedPaths)
+	{
+		if (Path.ResolveObject() == nullptr && !FailedInputAssetPaths.Contains(Path))
+		{
+			EXPERIENCE_LOG(Warning, TEXT("Input asset '%s' failed to load on [%s], continuing without it"), *Path.ToString(), *GetNameSafe(GetOwner()));
+			FailedInputAssetPaths.Add(Path);
+		}
+	}
+}
+
+void UExperienceHeroComponent::LoadDeviceInputMappings()
+{
+	if (DeviceInputMappings.Num() == 0)
+	{
+		return;
+	}
+
+	const EHardwareDevicePrimaryType DeviceType = GetCurrentDeviceType();
+	if (DeviceType == ActiveDeviceType)
+	{
+		return;
+	}
+
+	ActiveDeviceType = DeviceType;
+
+	TArray<FInputMappingContextAndPriority> Mappings;
+	GatherDeviceInputMappings(Mappings);
+
+	// Requested whether or not they are loaded already, the handle is what keeps the contexts of the active device resident
+	TArray<FSoftObjectPath> PathsToLoad;
+	for (const FInputMappingContextAndPriority& Mapping : Mappings)
+	{
+		if (!Mapping.InputMapping.IsNull())
+		{
+			PathsToLoad.AddUnique(Mapping.InputMapping.ToSoftObjectPath());
+		}
+	}
+
+	// The contexts of the previous device stay referenced by the enhanced input subsystem until they have been swapped out
+	if (TSharedPtr<FStreamableHandle> PreviousHandle = MoveTemp(DeviceInputMappingsLoadHandle))
+	{
+		PreviousHandle->CancelHandle();
+	}
+
+	if (PathsToLoad.Num() == 0)
+	{
+		if (bReadyToBindInputs)
+		{
+			ApplyDeviceInputMappings();
+		}
+		return;
+	}
+
+	EXPERIENCE_LOG(Verbose, TEXT("Streaming %d input mapping contexts of device type %s for [%s]"),
+		PathsToLoad.Num(), *UEnum::GetValueAsString(DeviceType), *GetNameSafe(GetOwner()));
+
+	DeviceInputMappingsLoadHandle = UAssetManager::GetStreamableManager().RequestAsyncLoad(PathsToLoad,
+		FStreamableDelegate::CreateUObject(this, &ThisClass::OnDeviceInputMappingsLoaded, PathsToLoad), FStreamableManager::AsyncLoadHighPriority);
+
+	if (!DeviceInputMappingsLoadHandle.IsValid())
+	{
+		OnDeviceInputMappingsLoaded(PathsToLoad);
+	}
+}
+
+void UExperienceHeroComponent::OnDeviceInputMappingsLoaded(TArray<FSoftObjectPath> RequestedPaths)
+{
+	NoteFailedInputAssets(RequestedPaths);
+
+	if (bReadyToBindInputs)
+	{
+		ApplyDeviceInputMappings();
+	}
+	else
+	{
+		CheckDefaultInitialization();
+	}
+}
+
+void UExperienceHeroComponent::ApplyDeviceInputMappings()
+{
+	const APlayerController* PC = GetController<APlayerController>();
+	const ULocalPlayer* LP = PC ? PC->GetLocalPlayer() : nullptr;
+	UEnhancedInputLocalPlayerSubsystem* InputSub = LP ? LP->GetSubsystem<UEnhancedInputLocalPlayerSubsystem>() : nullptr;
+	if (InputSub == nullptr)
+	{
+		return;
+	}
+
+	if (bApplyInputMappingsDifferentially)
+	{
+		const UExperiencePawnExtensionComponent* PawnExtComp = UExperiencePawnExtensionComponent::FindPawnExtensionComponent(GetOwner());
+
+		TArray<FInputMappingContextAndPriority> Mappings;
+		GatherInputMappings(PawnExtComp ? PawnExtComp->GetPawnData() : nullptr, Mappings);
+
+		LP->GetSubsystem<UExperienceInputMappingSubsystem>()->ApplyInputMappings(Mappings);
+		return;
+	}
+
+	TArray<FInputMappingContextAndPriority> Mappings;
+	GatherDeviceInputMappings(Mappings);
+
+	// Deferred, so the swap ends up in a single rebuild of the control mappings
+	FModifyContextOptions Options = {};
+	Options.bIgnoreAllPressedKeysUntilRelease = false;
+	Options.bForceImmediately = false;
+
+	for (UInputMappingContext* IMC : AppliedDeviceInputMappings)
+	{
+		if (IMC)
+		{
+			InputSub->RemoveMappingContext(IMC, Options);
+		}
+	}
+	AppliedDeviceInputMappings.Reset();
+
+	for (const FInputMappingContextAndPriority& Mapping : Mappings)
+	{
+		UInputMappingContext* IMC = Mapping.InputMapping.Get();
+		if (IMC == nullptr)
+		{
+			continue;
+		}
+
+		if (Mapping.bRegisterWithSettings)
+		{
+			UEnhancedInputUserSettings* Settings = InputSub->GetUserSettings();
+			if (Settings && !Settings->IsMappingContextRegistered(IMC))
+			{
+				Settings->RegisterInputMappingContext(IMC);
+			}
+		}
+
+		InputSub->AddMappingContext(IMC, Mapping.Priority, Options);
+		AppliedDeviceInputMappings.Add(IMC);
+	}
+}
+
+void UExperienceHeroComponent::OnInputHardwareDeviceChanged(const FPlatformUserId UserId, const FInputDeviceId DeviceId)
+{
+	const APlayerController* PC = GetController<APlayerController>();
+	if (PC == nullptr || PC->GetPlatformUserId() != UserId)
+	{
+		return;
+	}
+
+	LoadDeviceInputMappings();
 }
 
 void UExperienceHeroComponent::InitializePlayerInput(UInputComponent* InputComponent)
@@ -172,26 +499,57 @@ void UExperienceHeroComponent::InitializePlayerInput(UInputComponent* InputCompo
 	UEnhancedInputLocalPlayerSubsystem* InputSub = LP->GetSubsystem<UEnhancedInputLocalPlayerSubsystem>();
 	check(InputSub);
 
-	InputSub->ClearAllMappings();
+	UExperienceInputMappingSubsystem* MappingSub = LP->GetSubsystem<UExperienceInputMappingSubsystem>();
+	check(MappingSub);
+
+	if (!bApplyInputMappingsDifferentially)
+	{
+		InputSub->ClearAllMappings();
+		MappingSub->ResetAppliedMappings();
+	}
+
+	AppliedDeviceInputMappings.Reset();
 
 	const UExperiencePawnExtensionComponent* PawnExtComp = UExperiencePawnExtensionComponent::FindPawnExtensionComponent(Pawn);
 	const UExperiencePawnData* PawnData = PawnExtComp ? PawnExtComp->GetPawnData() : nullptr;
 	if (PawnData)
 	{
-		if (const UInputConfig* InputConfig = PawnData->InputConfig)
+		// Streamed in before the pawn got here, see LoadInputMappings
+		const UInputConfig* InputConfig = PawnData->InputConfig.Get();
+		if (InputConfig == nullptr && IsInputAssetPending(PawnData->InputConfig.ToSoftObjectPath()))
+		{
+			EXPERIENCE_LOG(Warning, TEXT("Input config '%s' wasn't loaded ahead of time on [%s]"), *PawnData->InputConfig.ToString(), *GetNameSafe(Pawn));
+			InputConfig = PawnData->InputConfig.LoadSynchronous();
+		}
+
+		// Built with the experience, bindings of this pawn are a single table swap
+		// Contributions of the experience apply whether or not the pawn data has an input config of its own
+		InputConfigTable = FindInputConfigTable(PawnData);
+
+		if (InputConfig || InputConfigTable.IsValid())
 		{
-			for (const auto& Mapping : DefaultInputMappings)
+			TArray<FInputMappingContextAndPriority> Mappings;
+			GatherInputMappings(PawnData, Mappings);
+
+			for (const auto& Mapping : Mappings)
 			{
-				if (UInputMappingContext* IMC = Mapping.InputMapping.LoadSynchronous()) //@TODO: ??
+				// Streamed in before the pawn got here, see LoadInputMappings
+				UInputMappingContext* IMC = Mapping.InputMapping.Get();
+				if (IMC == nullptr && IsInputAssetPending(Mapping.InputMapping.ToSoftObjectPath()))
 				{
-					if (!Mapping.bRegisterWithSettings)
-					{
-						continue;
-					}
+					EXPERIENCE_LOG(Warning, TEXT("Input mapping context '%s' wasn't loaded ahead of time on [%s]"), *Mapping.InputMapping.ToString(), *GetNameSafe(Pawn));
+					IMC = Mapping.InputMapping.LoadSynchronous();
+				}
 
-					if (UEnhancedInputUserSettings* Settings = InputSub->GetUserSettings())
+				if (IMC && !bApplyInputMappingsDifferentially)
+				{
+					// Only registration is optional, the context is added either way
+					if (Mapping.bRegisterWithSettings)
 					{
-						Settings->RegisterInputMappingContext(IMC);
+						if (UEnhancedInputUserSettings* Settings = InputSub->GetUserSettings())
+						{
+							Settings->RegisterInputMappingContext(IMC);
+						}
 					}
 
 					FModifyContextOptions Options = {};
@@ -200,11 +558,35 @@ void UExperienceHeroComponent::InitializePlayerInput(UInputComponent* InputCompo
 				}
 			}
 
-			OnInitializePlayerInput(InputComponent, InputConfig);
+			// Remembered so they can be swapped out when the player changes devices
+			TArray<FInputMappingContextAndPriority> DeviceMappings;
+			GatherDeviceInputMappings(DeviceMappings);
+			for (const FInputMappingContextAndPriority& Mapping : DeviceMappings)
+			{
+				if (UInputMappingContext* IMC = Mapping.InputMapping.Get())
+				{
+					AppliedDeviceInputMappings.Add(IMC);
+				}
+			}
+
+			if (DeviceInputMappings.Num() > 0)
+			{
+				if (UInputDeviceSubsystem* DeviceSubsystem = UInputDeviceSubsystem::Get())
+				{
+					DeviceSubsystem->OnInputHardwareDeviceChanged.AddUniqueDynamic(this, &ThisClass::OnInputHardwareDeviceChanged);
+				}
+			}
+
+			if (bApplyInputMappingsDifferentially)
+			{
+				MappingSub->ApplyInputMappings(Mappings);
+			}
+
+			OnInitializePlayerInput(InputComponent, InputConfig, InputConfigTable.Get());
 		}
 		else
 		{
-			EXPERIENCE_LOG(Error, TEXT("Input Config is not set on [%s]"), *GetNameSafe(Pawn));
+			EXPERIENCE_LOG(Error, TEXT("No input config or input config table for [%s]"), *GetNameSafe(Pawn));
 		}
 	}
 	else
@@ -239,6 +621,26 @@ void UExperienceHeroComponent::BeginPlay()
 void UExperienceHeroComponent::EndPlay(const EEndPlayReason::Type EndPlayReason)
 {
 	UnregisterInitStateFeature();
+
+	if (InputMappingsLoadHandle.IsValid())
+	{
+		InputMappingsLoadHandle->CancelHandle();
+		InputMappingsLoadHandle.Reset();
+	}
+
+	if (DeviceInputMappingsLoadHandle.IsValid())
+	{
+		DeviceInputMappingsLoadHandle->CancelHandle();
+		DeviceInputMappingsLoadHandle.Reset();
+	}
+
+	if (UInputDeviceSubsystem* DeviceSubsystem = UInputDeviceSubsystem::Get())
+	{
+		DeviceSubsystem->OnInputHardwareDeviceChanged.RemoveAll(this);
+	}
+
+	InputConfigTable.Reset();
+	FailedInputAssetPaths.Reset();
 	
 	Super::EndPlay(EndPlayReason);
 }
@@ -0,0 +1,34 @@
+// Copyright © 2024 Playton. All Rights Reserved.
+
+
+#include "Components/ExperienceInitStateChain.h"
+
+bool FExperienceInitStateChain::Compile(TConstArrayView<FGameplayTag> InStates, FString& OutError)
+{
+	States.Reset();
+
+	if (InStates.Num() < MinNumStages)
+	{
+		OutError = FString::Printf(TEXT("The chain needs at least %d states (Spawned, Available, Initialized and Ready), got %d"), MinNumStages, InStates.Num());
+		return false;
+	}
+
+	for (int32 Stage = 0; Stage < InStates.Num(); ++Stage)
+	{
+		const FGameplayTag& State = InStates[Stage];
+		if (!State.IsValid())
+		{
+			OutError = FString::Printf(TEXT("State %d of the chain is empty"), Stage);
+			return false;
+		}
+
+		if (InStates.Left(Stage).Contains(State))
+		{
+			OutError = FString::Printf(TEXT("State %s is in the chain more than once"), *State.ToString());
+			return false;
+		}
+	}
+
+	States = InStates;
+	return true;
+}
@@ -0,0 +1,114 @@
+// Copyright © 2024 Playton. All Rights Reserved.
+
+
+#include "Components/ExperienceInitStateCoordinator.h"
+
+#include "Components/GameFrameworkComponentManager.h"
+#include "Components/GameFrameworkInitStateInterface.h"
+#include "GameFramework/Actor.h"
+
+void FExperienceInitStateCoordinator::Initialize(UGameFrameworkComponentManager* Manager, AActor* Actor, FName InOwnerFeature, FGameplayTag InTargetState)
+{
+	check(Manager && Actor);
+
+	FeatureReached.Reset();
+	NumPendingFeatures = 0;
+	TargetState = InTargetState;
+	OwnerFeature = InOwnerFeature;
+	bTracking = true;
+
+	TArray<FName, TInlineAllocator<8>> FeatureNames;
+	if (const IGameFrameworkInitStateInterface* ActorInitState = Cast<IGameFrameworkInitStateInterface>(Actor))
+	{
+		FeatureNames.AddUnique(ActorInitState->GetFeatureName());
+	}
+
+	Actor->ForEachComponent(false, [&FeatureNames](UActorComponent* Component)
+	{
+		if (const IGameFrameworkInitStateInterface* ComponentInitState = Cast<IGameFrameworkInitStateInterface>(Component))
+		{
+			FeatureNames.AddUnique(ComponentInitState->GetFeatureName());
+		}
+	});
+
+	for (const FName& FeatureName : FeatureNames)
+	{
+		if (FeatureName == OwnerFeature)
+		{
+			continue;
+		}
+
+		// Features that haven't entered any state yet are picked up from their first state change
+		const FGameplayTag FeatureState = Manager->GetInitStateForFeature(Actor, FeatureName);
+		if (FeatureState.IsValid())
+		{
+			SetFeatureReached(FeatureName, Manager->IsInitStateAfterOrEqual(FeatureState, TargetState));
+		}
+	}
+}
+
+void FExperienceInitStateCoordinator::Finish()
+{
+	bTracking = false;
+	FeatureReached.Reset();
+	NumPendingFeatures = 0;
+}
+
+bool FExperienceInitStateCoordinator::HandleFeatureStateChanged(UGameFrameworkComponentManager* Manager, const FActorInitStateChangedParams& Params)
+{
+	if (!bTracking || Params.FeatureName == OwnerFeature || !Params.FeatureState.IsValid())
+	{
+		return false;
+	}
+
+	const int32 NumPendingBefore = NumPendingFeatures;
+
+	// Includes features that entered their first state after we started, e.g. components added by a game feature
+	SetFeatureReached(Params.FeatureName, Manager->IsInitStateAfterOrEqual(Params.FeatureState, TargetState));
+
+	// Only the last outstanding feature lets the owner advance
+	return NumPendingBefore > 0 && NumPendingFeatures == 0;
+}
+
+bool FExperienceInitStateCoordinator::Refresh(UGameFrameworkComponentManager* Manager, AActor* Actor)
+{
+	for (auto It = FeatureReached.CreateIterator(); It; ++It)
+	{
+		// Tracked features always had a state, losing it means the feature unregistered
+		if (!It.Value() && !Manager->GetInitStateForFeature(Actor, It.Key()).IsValid())
+		{
+			--NumPendingFeatures;
+			It.RemoveCurrent();
+		}
+	}
+
+	return IsComplete();
+}
+
+FName FExperienceInitStateCoordinator::GetFirstPendingFeature() const
+{
+	for (const TPair<FName, bool>& Pair : FeatureReached)
+	{
+		if (!Pair.Value)
+		{
+			return Pair.Key;
+		}
+	}
+
+	return NAME_None;
+}
+
+void FExperienceInitStateCoordinator::SetFeatureReached(FName FeatureName, bool bReached)
+{
+	bool* bWasReached = FeatureReached.Find(FeatureName);
+	if (bWasReached == nullptr)
+	{
+		FeatureReached.Add(FeatureName, bReached);
+		NumPendingFeatures += bReached ? 0 : 1;
+	}
+	else if (*bWasReached != bReached)
+	{
+		*bWasReached = bReached;
+		NumPendingFeatures += bReached ? -1 : 1;
+	}
+}
@@ -0,0 +1,182 @@
+// Copyright © 2024 Playton. All Rights Reserved.
+
+
+#include "Components/ExperienceInitStateMetrics.h"
+
+#include "GameplayExperiencesStats.h"
+#include "GameFramework/Actor.h"
+#include "HAL/IConsoleManager.h"
+#include "Misc/OutputDevice.h"
+#include "ProfilingDebugging/CsvProfiler.h"
+
+CSV_DEFINE_CATEGORY(GameplayExperiences, true);
+
+DECLARE_DWORD_COUNTER_STAT(TEXT("Pawns Ready"), STAT_ExperiencePawnsReady, STATGROUP_GameplayExperiences);
+DECLARE_FLOAT_ACCUMULATOR_STAT(TEXT("Last Time To Ready (ms)"), STAT_ExperienceLastTimeToReady, STATGROUP_GameplayExperiences);
+DECLARE_FLOAT_ACCUMULATOR_STAT(TEXT("Last Init Stage (ms)"), STAT_ExperienceLastInitStage, STATGROUP_GameplayExperiences);
+
+namespace ExperienceInitStateCVars
+{
+	static bool bCollectMetrics = !UE_BUILD_SHIPPING;
+	static FAutoConsoleVariableRef CVarCollectMetrics(
+		TEXT("Experience.InitState.Metrics"),
+		bCollectMetrics,
+		TEXT("If true, time spent by pawns in each init state is collected. See Experience.InitState.DumpMetrics."),
+		ECVF_Default);
+
+	static FAutoConsoleCommandWithOutputDevice DumpMetricsCommand(
+		TEXT("Experience.InitState.DumpMetrics"),
+		TEXT("Dumps the time pawns spent in each init state, per pawn class and feature."),
+		FConsoleCommandWithOutputDeviceDelegate::CreateStatic(&FExperienceInitStateMetrics::Dump));
+
+	static FAutoConsoleCommand ResetMetricsCommand(
+		TEXT("Experience.InitState.ResetMetrics"),
+		TEXT("Drops the init state metrics collected so far."),
+		FConsoleCommandDelegate::CreateStatic(&FExperienceInitStateMetrics::Reset));
+}
+
+namespace ExperienceInitStateMetrics
+{
+	/** Identifies a stage of a feature, or the whole chain when the feature is none. */
+	struct FStageKey
+	{
+		FName PawnClass;
+		FName Feature;
+		FName State;
+
+		bool operator==(const FStageKey& Other) const
+		{
+			return PawnClass == Other.PawnClass && Feature == Other.Feature && State == Other.State;
+		}
+
+		friend uint32 GetTypeHash(const FStageKey& Key)
+		{
+			return HashCombine(HashCombine(GetTypeHash(Key.PawnClass), GetTypeHash(Key.Feature)), GetTypeHash(Key.State));
+		}
+	};
+
+	static TMap<FStageKey, FExperienceInitStateMetrics::FHistogram> Histograms;
+}
+
+const float FExperienceInitStateMetrics::BucketBoundsMs[NumBuckets - 1] = { 1.f, 2.f, 5.f, 10.f, 20.f, 50.f, 100.f, 200.f, 500.f, 1000.f, 5000.f };
+
+void FExperienceInitStateMetrics::FHistogram::Add(double DurationMs)
+{
+	int32 BucketIndex = 0;
+	while (BucketIndex < NumBuckets - 1 && DurationMs > BucketBoundsMs[BucketIndex])
+	{
+		++BucketIndex;
+	}
+
+	++Buckets[BucketIndex];
+	++Count;
+	TotalMs += DurationMs;
+	MaxMs = FMath::Max(MaxMs, DurationMs);
+}
+
+double FExperienceInitStateMetrics::FHistogram::GetPercentileMs(double Percentile) const
+{
+	const uint32 Target = FMath::CeilToInt(Count * FMath::Clamp(Percentile, 0.0, 1.0));
+
+	uint32 Accumulated = 0;
+	for (int32 BucketIndex = 0; BucketIndex < NumBuckets - 1; ++BucketIndex)
+	{
+		Accumulated += Buckets[BucketIndex];
+		if (Accumulated >= Target)
+		{
+			return BucketBoundsMs[BucketIndex];
+		}
+	}
+
+	return MaxMs;
+}
+
+bool FExperienceInitStateMetrics::IsEnabled()
+{
+	return ExperienceInitStateCVars::bCollectMetrics;
+}
+
+void FExperienceInitStateMetrics::RecordStage(const AActor* Pawn, FName FeatureName, FGameplayTag FromState, FGameplayTag ToState, double StateEnterTime)
+{
+	// Nothing to measure before the first state has been entered
+	if (!IsEnabled() || Pawn == nullptr || !FromState.IsValid() || StateEnterTime <= 0.0)
+	{
+		return;
+	}
+
+	const double DurationMs = (FPlatformTime::Seconds() - StateEnterTime) * 1000.0;
+
+	using namespace ExperienceInitStateMetrics;
+	Histograms.FindOrAdd(FStageKey{ Pawn->GetClass()->GetFName(), FeatureName, FromState.GetTagName() }).Add(DurationMs);
+
+	SET_FLOAT_STAT(STAT_ExperienceLastInitStage, DurationMs);
+}
+
+void FExperienceInitStateMetrics::RecordTimeToReady(const AActor* Pawn, double InitStartTime)
+{
+	if (!IsEnabled() || Pawn == nullptr || InitStartTime <= 0.0)
+	{
+		return;
+	}
+
+	const double DurationMs = (FPlatformTime::Seconds() - InitStartTime) * 1000.0;
+
+	using namespace ExperienceInitStateMetrics;
+	Histograms.FindOrAdd(FStageKey{ Pawn->GetClass()->GetFName(), NAME_None, NAME_None }).Add(DurationMs);
+
+	INC_DWORD_STAT(STAT_ExperiencePawnsReady);
+	SET_FLOAT_STAT(STAT_ExperienceLastTimeToReady, DurationMs);
+	CSV_CUSTOM_STAT(GameplayExperiences, TimeToReadyMs, static_cast<float>(DurationMs), ECsvCustomStatOp::Max);
+	CSV_CUSTOM_STAT(GameplayExperiences, PawnsReady, 1, ECsvCustomStatOp::Accumulate);
+}
+
+void FExperienceInitStateMetrics::Dump(FOutputDevice& Ar)
+{
+	using namespace ExperienceInitStateMetrics;
+
+	if (Histograms.IsEmpty())
+	{
+		Ar.Logf(TEXT("No init state metrics collected. (Experience.InitState.Metrics=%d)"), IsEnabled() ? 1 : 0);
+		return;
+	}
+
+	// Group by pawn class, then feature and stage, so the slow stage of a class stands out
+	TArray<FStageKey> Keys;
+	Histograms.GetKeys(Keys);
+	Keys.Sort([](const FStageKey& A, const FStageKey& B)
+	{
+		if (A.PawnClass != B.PawnClass) { return A.PawnClass.LexicalLess(B.PawnClass); }
+		if (A.Feature != B.Feature) { return A.Feature.LexicalLess(B.Feature); }
+		return A.State.LexicalLess(B.State);
+	});
+
+	FString BucketHeader;
+	for (int32 BucketIndex = 0; BucketIndex < NumBuckets - 1; ++BucketIndex)
+	{
+		BucketHeader += FString::Printf(TEXT(" <=%g"), BucketBoundsMs[BucketIndex]);
+	}
+	BucketHeader += TEXT(" >");
+
+	Ar.Logf(TEXT("Init state metrics (ms), buckets:%s"), *BucketHeader);
+
+	for (const FStageKey& Key : Keys)
+	{
+		const FHistogram& Histogram = Histograms.FindChecked(Key);
+
+		FString Buckets;
+		for (int32 BucketIndex = 0; BucketIndex < NumBuckets; ++BucketIndex)
+		{
+			Buckets += FString::Printf(TEXT(" %u"), Histogram.Buckets[BucketIndex]);
+		}
+
+		const FString Stage = Key.Feature.IsNone() ? FString(TEXT("TimeToReady")) : FString::Printf(TEXT("%s in %s"), *Key.Feature.ToString(), *Key.State.ToString());
+		Ar.Logf(TEXT("  %s | %s: count=%u avg=%.2f p50<=%.0f p95<=%.0f max=%.2f |%s"),
+			*Key.PawnClass.ToString(), *Stage, Histogram.Count, Histogram.GetAverageMs(),
+			Histogram.GetPercentileMs(0.5), Histogram.GetPercentileMs(0.95), Histogram.MaxMs, *Buckets);
+	}
+}
+
+void FExperienceInitStateMetrics::Reset()
+{
+	ExperienceInitStateMetrics::Histograms.Reset();
+}
@@ -0,0 +1,195 @@
+// Copyright © 2024 Playton. All Rights Reserved.
+
+
+#include "Components/ExperienceInitStateTrace.h"
+
+#include "GameplayExperiencesLog.h"
+#include "GameFramework/Actor.h"
+#include "HAL/IConsoleManager.h"
+#include "Misc/App.h"
+
+namespace ExperienceInitStateCVars
+{
+	static float StuckThreshold = 5.f;
+	static FAutoConsoleVariableRef CVarStuckThreshold(
+		TEXT("Experience.InitState.StuckThreshold"),
+		StuckThreshold,
+		TEXT("Time in seconds after which a pawn still going through its init states counts as stuck."),
+		ECVF_Default);
+
+	static float StuckSummaryInterval = 5.f;
+	static FAutoConsoleVariableRef CVarStuckSummaryInterval(
+		TEXT("Experience.InitState.StuckSummaryInterval"),
+		StuckSummaryInterval,
+		TEXT("Minimum time in seconds between two summaries of stuck pawns. 0 disables the summaries."),
+		ECVF_Default);
+}
+
+const TCHAR* LexToString(EExperienceInitStateReason Reason)
+{
+	switch (Reason)
+	{
+	case EExperienceInitStateReason::Transitioned:			return TEXT("Transitioned");
+	case EExperienceInitStateReason::InvalidPawn:			return TEXT("InvalidPawn");
+	case EExperienceInitStateReason::MissingPawnData:		return TEXT("MissingPawnData");
+	case EExperienceInitStateReason::MissingController:		return TEXT("MissingController");
+	case EExperienceInitStateReason::MissingPlayerState:	return TEXT("MissingPlayerState");
+	case EExperienceInitStateReason::WaitingForFeatures:	return TEXT("WaitingForFeatures");
+	case EExperienceInitStateReason::InvalidTransition:		return TEXT("InvalidTransition");
+	default:												return TEXT("Unknown");
+	}
+}
+
+#if EXPERIENCE_INITSTATE_TRACE_ENABLED
+
+UE_TRACE_CHANNEL_DEFINE(ExperienceInitStateChannel)
+
+UE_TRACE_EVENT_BEGIN(GameplayExperiences, InitStateName, NoSync|Important)
+	UE_TRACE_EVENT_FIELD(uint32, Id)
+	UE_TRACE_EVENT_FIELD(UE::Trace::WideString, Name)
+UE_TRACE_EVENT_END()
+
+UE_TRACE_EVENT_BEGIN(GameplayExperiences, InitStateTransition)
+	UE_TRACE_EVENT_FIELD(uint64, Cycle)
+	UE_TRACE_EVENT_FIELD(uint64, PawnId)
+	UE_TRACE_EVENT_FIELD(uint32, PawnClassId)
+	UE_TRACE_EVENT_FIELD(uint32, FeatureId)
+	UE_TRACE_EVENT_FIELD(uint32, FromStateId)
+	UE_TRACE_EVENT_FIELD(uint32, ToStateId)
+	UE_TRACE_EVENT_FIELD(uint8, Reason)
+UE_TRACE_EVENT_END()
+
+namespace ExperienceInitStateTrace
+{
+	/** Returns the trace id of a name, declaring it the first time it is seen. */
+	static uint32 GetNameId(FName Name)
+	{
+		if (Name.IsNone())
+		{
+			return 0;
+		}
+
+		static TSet<uint32> DeclaredNames;
+
+		const uint32 Id = Name.GetComparisonIndex().ToUnstableInt();
+		bool bAlreadyDeclared = false;
+		DeclaredNames.Add(Id, &bAlreadyDeclared);
+
+		if (!bAlreadyDeclared)
+		{
+			const FString NameString = Name.ToString();
+			UE_TRACE_LOG(GameplayExperiences, InitStateName, ExperienceInitStateChannel)
+				<< InitStateName.Id(Id)
+				<< InitStateName.Name(*NameString, NameString.Len());
+		}
+
+		return Id;
+	}
+}
+
+void FExperienceInitStateTrace::OutputTransition(const AActor* Pawn, FName FeatureName, FGameplayTag FromState, FGameplayTag ToState, EExperienceInitStateReason Reason)
+{
+	check(IsInGameThread());
+
+	const uint32 PawnClassId = Pawn ? ExperienceInitStateTrace::GetNameId(Pawn->GetClass()->GetFName()) : 0;
+	const uint32 FeatureId = ExperienceInitStateTrace::GetNameId(FeatureName);
+	const uint32 FromStateId = ExperienceInitStateTrace::GetNameId(FromState.GetTagName());
+	const uint32 ToStateId = ExperienceInitStateTrace::GetNameId(ToState.GetTagName());
+
+	UE_TRACE_LOG(GameplayExperiences, InitStateTransition, ExperienceInitStateChannel)
+		<< InitStateTransition.Cycle(FPlatformTime::Cycles64())
+		<< InitStateTransition.PawnId(reinterpret_cast<UPTRINT>(Pawn))
+		<< InitStateTransition.PawnClassId(PawnClassId)
+		<< InitStateTransition.FeatureId(FeatureId)
+		<< InitStateTransition.FromStateId(FromStateId)
+		<< InitStateTransition.ToStateId(ToStateId)
+		<< InitStateTransition.Reason(static_cast<uint8>(Reason));
+}
+
+#endif
+
+namespace ExperienceInitStateStuckPawns
+{
+	/** Number of pawns currently stuck, across every world. */
+	static int32 NumStuckPawns = 0;
+
+	/** Number of refused transitions of stuck pawns since the last summary. */
+	static int32 NumRefusals = 0;
+
+	static double LastSummaryTime = 0.0;
+
+	/** Time in seconds between two checks of a tracked pawn. */
+	static constexpr float CheckInterval = 1.f;
+}
+
+void FExperienceInitStateStuckTracker::Begin(const AActor* InPawn)
+{
+	End();
+
+	Pawn = InPawn;
+	WaitingOn = NAME_None;
+	Reason = EExperienceInitStateReason::Transitioned;
+	StartTime = FApp::GetCurrentTime();
+	TickerHandle = FTSTicker::GetCoreTicker().AddTicker(FTickerDelegate::CreateRaw(this, &FExperienceInitStateStuckTracker::Tick), ExperienceInitStateStuckPawns::CheckInterval);
+}
+
+void FExperienceInitStateStuckTracker::NoteWaiting(FName InWaitingOn, EExperienceInitStateReason InReason)
+{
+	WaitingOn = InWaitingOn;
+	Reason = InReason;
+
+	if (bStuck)
+	{
+		++ExperienceInitStateStuckPawns::NumRefusals;
+	}
+}
+
+bool FExperienceInitStateStuckTracker::Tick(float DeltaTime)
+{
+	using namespace ExperienceInitStateStuckPawns;
+
+	if (ExperienceInitStateCVars::StuckSummaryInterval <= 0.f)
+	{
+		return true;
+	}
+
+	const double Now = FApp::GetCurrentTime();
+	if (Now - StartTime < ExperienceInitStateCVars::StuckThreshold)
+	{
+		return true;
+	}
+
+	if (!bStuck)
+	{
+		bStuck = true;
+		++NumStuckPawns;
+	}
+
+	if (Now - LastSummaryTime < ExperienceInitStateCVars::StuckSummaryInterval)
+	{
+		return true;
+	}
+
+	EXPERIENCE_LOG(Warning, TEXT("%d pawns stuck initializing (%d refused transitions since the last summary), e.g. %s for %.1fs waiting on %s (%s)."),
+		NumStuckPawns, NumRefusals, *GetNameSafe(Pawn.Get()), Now - StartTime, *WaitingOn.ToString(), LexToString(Reason));
+
+	LastSummaryTime = Now;
+	NumRefusals = 0;
+
+	return true;
+}
+
+void FExperienceInitStateStuckTracker::End()
+{
+	if (TickerHandle.IsValid())
+	{
+		FTSTicker::GetCoreTicker().RemoveTicker(TickerHandle);
+		TickerHandle.Reset();
+	}
+
+	if (bStuck)
+	{
+		bStuck = false;
+		--ExperienceInitStateStuckPawns::NumStuckPawns;
+	}
+}
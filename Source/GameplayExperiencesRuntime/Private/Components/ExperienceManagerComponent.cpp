@@ -4,17 +4,111 @@
 #include "Components/ExperienceManagerComponent.h"
 
 #include "ExperienceDefinition.h"
+#include "AbilitySystem/ExperienceAbilitySystemComponent.h"
+#include "Actions/ExperienceResettableAction.h"
 #include "ExperienceManagerSubsystem.h"
 #include "GameFeatureAction.h"
 #include "GameFeatureActionSet.h"
 #include "GameFeaturesSubsystem.h"
 #include "GameFeaturesSubsystemSettings.h"
 #include "GameplayExperiencesLog.h"
+#include "InputAction.h"
+#include "InputMappingContext.h"
+#include "Input/ExperienceInputConfigTable.h"
+#include "Input/InputConfig.h"
+#include "Abilities/GameplayAbility.h"
+#include "AbilitySystemGlobals.h"
 #include "Engine/AssetManager.h"
+#include "Engine/LevelStreaming.h"
+#include "GameplayCueManager.h"
+#include "GameplayCueNotify_Actor.h"
+#include "GameplayCueNotify_Static.h"
+#include "GameplayCueSet.h"
+#include "GameplayEffect.h"
+#include "UObject/PropertyIterator.h"
+#include "UObject/UObjectHash.h"
+#include "WorldPartition/WorldPartitionSubsystem.h"
+#include "GameFramework/GameStateBase.h"
 #include "Net/UnrealNetwork.h"
 
 #include UE_INLINE_GENERATED_CPP_BY_NAME(ExperienceManagerComponent)
 
+namespace ExperiencePreload
+{
+	static bool IsPreloadedClass(const UClass* Class)
+	{
+		return Class && (Class->IsChildOf<UGameplayAbility>()
+			|| Class->IsChildOf<UGameplayEffect>()
+			|| Class->IsChildOf<UGameplayCueNotify_Static>()
+			|| Class->IsChildOf<AGameplayCueNotify_Actor>());
+	}
+
+	/** Gathers the gameplay classes the object references, either softly or as already loaded classes. */
+	static void GatherClassReferences(const UObject* Object, TSet<FSoftObjectPath>& OutPaths, TSet<UClass*>& OutClasses)
+	{
+		if (Object == nullptr)
+		{
+			return;
+		}
+
+		for (TPropertyValueIterator<FProperty> It(Object->GetClass(), Object); It; ++It)
+		{
+			if (const FSoftClassProperty* SoftClassProperty = CastField<FSoftClassProperty>(It.Key()))
+			{
+				const FSoftObjectPtr& SoftClass = *static_cast<const FSoftObjectPtr*>(It.Value());
+				if (!SoftClass.IsNull() && IsPreloadedClass(SoftClassProperty->MetaClass))
+				{
+					OutPaths.Add(SoftClass.ToSoftObjectPath());
+				}
+			}
+			else if (const FClassProperty* ClassProperty = CastField<FClassProperty>(It.Key()))
+			{
+				UClass* Class = Cast<UClass>(ClassProperty->GetObjectPropertyValue(It.Value()));
+				if (IsPreloadedClass(Class))
+				{
+					OutClasses.Add(Class);
+				}
+			}
+		}
+	}
+}
+
+namespace ExperienceServerFootprint
+{
+	static bool bValidateOnLoad = !UE_BUILD_SHIPPING;
+	static FAutoConsoleVariableRef CVarValidateOnLoad(
+		TEXT("Experience.Server.ValidateInputFootprint"),
+		bValidateOnLoad,
+		TEXT("If true, dedicated servers check that no input asset has been loaded once an experience has loaded."),
+		ECVF_Default);
+
+	/** Lists the input configs, input actions and input mapping contexts loaded in the process. Returns how many there are. */
+	static int32 ReportLoadedInputAssets(FOutputDevice& Ar)
+	{
+		int32 NumInputAssets = 0;
+
+		for (const UClass* InputAssetClass : { UInputConfig::StaticClass(), UInputAction::StaticClass(), UInputMappingContext::StaticClass() })
+		{
+			ForEachObjectOfClass(InputAssetClass, [&Ar, &NumInputAssets](UObject* Object)
+			{
+				if (!Object->HasAnyFlags(RF_ClassDefaultObject | RF_ArchetypeObject))
+				{
+					Ar.Logf(TEXT("  %s"), *Object->GetFullName());
+					++NumInputAssets;
+				}
+			});
+		}
+
+		Ar.Logf(TEXT("%d input assets loaded"), NumInputAssets);
+		return NumInputAssets;
+	}
+
+	static FAutoConsoleCommandWithOutputDevice CheckInputFootprintCommand(
+		TEXT("Experience.Server.CheckInputFootprint"),
+		TEXT("Lists the input configs, input actions and input mapping contexts loaded in this process. Dedicated servers shouldn't have any."),
+		FConsoleCommandWithOutputDeviceDelegate::CreateLambda([](FOutputDevice& Ar) { ReportLoadedInputAssets(Ar); }));
+}
+
 using namespace GameplayExperiences;
 
 //@TODO: Async load the experience definition itself
@@ -54,15 +148,42 @@ void UExperienceManagerComponent::EndPlay(const EEndPlayReason::Type EndPlayReas
 {
 	Super::EndPlay(EndPlayReason);
 
-	// Deactivate any features this experience loaded
+	// Deactivate any features this experience loaded, unless other worlds (or the game mode) still need them
 	for (const FString& PluginRUL : GameFeaturePluginURLs)
 	{
-		if (UExperienceManagerSubsystem::RequestToDeactivatePlugin(PluginRUL))
+		if (UExperienceManagerSubsystem::RequestToDeactivatePlugin(PluginRUL, this))
 		{
 			UGameFeaturesSubsystem::Get().DeactivateGameFeaturePlugin(PluginRUL);
 		}
 	}
 
+	// Stop preloading, the cancel callback mustn't pick the load back up
+	if (LoadState == EExperienceLoadState::Preloading)
+	{
+		LoadState = EExperienceLoadState::Unloaded;
+	}
+	if (TSharedPtr<FStreamableHandle> Handle = MoveTemp(PreloadHandle))
+	{
+		Handle->CancelHandle();
+	}
+	PreloadedClasses.Reset();
+
+	InputConfigContributions.Reset();
+	InputConfigTables.Reset();
+
+	// A reset still waiting on its actions is abandoned, everything is deactivated below anyway
+	ResettingActions.Reset();
+	OnResetActionsComplete.Unbind();
+
+	// Same for the bundles, which are shared by every world hosting an experience
+	UExperienceManagerSubsystem::Get()->ReleaseExperienceBundles(GetWorld());
+
+	// Compiled tag relationships are shared as well, drop them once nobody hosts an experience anymore
+	if (UExperienceManagerSubsystem::Get()->GetNumHostedExperiences() == 0)
+	{
+		FExperienceCompiledTagRelationships::Reset();
+	}
+
 	if (LoadState == EExperienceLoadState::Loaded)
 	{
 		LoadState = EExperienceLoadState::Deactivating;
@@ -123,6 +244,55 @@ bool UExperienceManagerComponent::ShouldShowLoadingScreen(FString& OutReason) co
 		return true;
 	}
 
+	// Only the streaming before the match starts holds the loading screen, cells streamed in during the match don't
+	if (!bInitialLevelStreamingDone && IsLevelStreamingPending(GetWorld()))
+	{
+		OutReason = TEXT("Waiting for level streaming");
+		return true;
+	}
+
+	// The server holds back StartPlay until level streaming (and, if it is set up to, the experience) is done, see AModularExperienceGameModeBase::StartPlay
+	const AGameStateBase* GameState = GetGameStateChecked<AGameStateBase>();
+	if (!GameState->HasBegunPlay())
+	{
+		OutReason = TEXT("Waiting for the match to start");
+		return true;
+	}
+
+	bInitialLevelStreamingDone = true;
+	return false;
+}
+
+bool UExperienceManagerComponent::IsLevelStreamingPending(const UWorld* World)
+{
+	if (World == nullptr)
+	{
+		return false;
+	}
+
+	if (World->IsVisibilityRequestPending())
+	{
+		return true;
+	}
+
+	for (const ULevelStreaming* StreamingLevel : World->GetStreamingLevels())
+	{
+		if (StreamingLevel && StreamingLevel->IsStreamingStatePending())
+		{
+			return true;
+		}
+	}
+
+	// World partition cells don't show up as streaming levels until they start loading
+	if (World->IsPartitionedWorld())
+	{
+		UWorldPartitionSubsystem* WorldPartitionSubsystem = World->GetSubsystem<UWorldPartitionSubsystem>();
+		if (WorldPartitionSubsystem && !WorldPartitionSubsystem->IsAllStreamingCompleted())
+		{
+			return true;
+		}
+	}
+
 	return false;
 }
 
@@ -234,6 +404,13 @@ void UExperienceManagerComponent::StartExperienceLoad()
 		}
 	}
 
+	// Pawn data carry their own bundles (pawn class, input config, tag relationships), which always match the pawn data as saved
+	TArray<FPrimaryAssetId> PawnDataIds;
+	TArray<FSoftObjectPath> UnregisteredPawnData;
+	UExperienceManagerSubsystem::GetExperiencePawnData(CurrentExperience, PawnDataIds, UnregisteredPawnData);
+	BundleAssetList.Append(PawnDataIds);
+	RawAssetList.Append(UnregisteredPawnData);
+
 	// Load assets associated with the experience
 	TArray<FName> BundlesToLoad;
 	BundlesToLoad.Add("Equipped");
@@ -251,11 +428,9 @@ void UExperienceManagerComponent::StartExperienceLoad()
 		BundlesToLoad.Add(UGameFeaturesSubsystemSettings::LoadStateServer);
 	}
 
-	TSharedPtr<FStreamableHandle> BundleLoadHandle = nullptr;
-	if (BundleAssetList.Num() > 0)
-	{
-		BundleLoadHandle = AssetManager.ChangeBundleStateForPrimaryAssets(BundleAssetList.Array(), BundlesToLoad, {}, false, FStreamableDelegate(), FStreamableManager::AsyncLoadHighPriority);
-	}
+	// Bundle state is process-wide, let the subsystem refcount it against the other worlds hosting experiences
+	TSharedPtr<FStreamableHandle> BundleLoadHandle = UExperienceManagerSubsystem::Get()->AcquireExperienceBundles(
+		GetWorld(), CurrentExperience->GetPrimaryAssetId(), BundleAssetList.Array(), BundlesToLoad);
 
 	TSharedPtr<FStreamableHandle> RawLoadHandle = nullptr;
 	if (RawAssetList.Num() > 0)
@@ -342,13 +517,13 @@ void UExperienceManagerComponent::OnExperienceLoadComplete()
 		LoadState = EExperienceLoadState::LoadingGameFeatures;
 		for (const FString& PluginURL : GameFeaturePluginURLs)
 		{
-			UExperienceManagerSubsystem::NotifyOfPluginActivation(PluginURL);
+			UExperienceManagerSubsystem::NotifyOfPluginActivation(PluginURL, this);
 			UGameFeaturesSubsystem::Get().LoadAndActivateGameFeaturePlugin(PluginURL, FGameFeaturePluginLoadComplete::CreateUObject(this, &ThisClass::OnGameFeaturePluginLoadComplete));
 		}
 	}
 	else
 	{
-		OnExperienceFullLoadCompleted();
+		StartExperiencePreload();
 	}
 }
 
@@ -358,8 +533,242 @@ void UExperienceManagerComponent::OnGameFeaturePluginLoadComplete(const UE::Game
 	NumGameFeaturePluginsLoading--;
 
 	if (NumGameFeaturePluginsLoading == 0)
+	{
+		StartExperiencePreload();
+	}
+}
+
+void UExperienceManagerComponent::StartExperiencePreload()
+{
+	check(CurrentExperience != nullptr);
+
+	if (!bPreloadGameplayClasses)
 	{
 		OnExperienceFullLoadCompleted();
+		return;
+	}
+
+	LoadState = EExperienceLoadState::Preloading;
+	PreloadStartTime = FPlatformTime::Seconds();
+
+	TSet<FSoftObjectPath> ClassPaths;
+	TSet<UClass*> LoadedClasses;
+
+	for (const UGameFeatureAction* Action : CurrentExperience->FeatureActions)
+	{
+		ExperiencePreload::GatherClassReferences(Action, ClassPaths, LoadedClasses);
+	}
+	for (const TObjectPtr<UGameFeatureActionSet>& ActionSet : CurrentExperience->FeatureActionSets)
+	{
+		if (ActionSet != nullptr)
+		{
+			for (const UGameFeatureAction* Action : ActionSet->Actions)
+			{
+				ExperiencePreload::GatherClassReferences(Action, ClassPaths, LoadedClasses);
+			}
+		}
+	}
+
+	// Streamed with the bundles of the experience
+	ExperiencePreload::GatherClassReferences(CurrentExperience->DefaultPawnData.Get(), ClassPaths, LoadedClasses);
+	ExperiencePreload::GatherClassReferences(CurrentExperience->BotFillSettings.BotPawnData.Get(), ClassPaths, LoadedClasses);
+
+	PreloadedClasses.Append(LoadedClasses.Array());
+
+	if (ClassPaths.Num() == 0)
+	{
+		OnPreloadClassesLoaded();
+		return;
+	}
+
+	PreloadHandle = UAssetManager::Get().LoadAssetList(ClassPaths.Array(), FStreamableDelegate(), FStreamableManager::AsyncLoadHighPriority);
+	if (!PreloadHandle.IsValid() || PreloadHandle->HasLoadCompleted())
+	{
+		OnPreloadClassesLoaded();
+	}
+	else
+	{
+		PreloadHandle->BindCompleteDelegate(FStreamableDelegate::CreateUObject(this, &ThisClass::OnPreloadClassesLoaded));
+		PreloadHandle->BindCancelDelegate(FStreamableDelegate::CreateUObject(this, &ThisClass::OnPreloadClassesLoaded));
+	}
+}
+
+void UExperienceManagerComponent::OnPreloadClassesLoaded()
+{
+	if (LoadState != EExperienceLoadState::Preloading)
+	{
+		return;
+	}
+
+	if (PreloadHandle.IsValid())
+	{
+		TArray<UObject*> LoadedAssets;
+		PreloadHandle->GetLoadedAssets(LoadedAssets);
+		for (UObject* LoadedAsset : LoadedAssets)
+		{
+			if (UClass* LoadedClass = Cast<UClass>(LoadedAsset))
+			{
+				PreloadedClasses.AddUnique(LoadedClass);
+			}
+		}
+
+		PreloadHandle->ReleaseHandle();
+		PreloadHandle.Reset();
+	}
+
+	// Abilities pull in their cost and cooldown effects, which are loaded along with them
+	for (int32 Index = 0; Index < PreloadedClasses.Num(); ++Index)
+	{
+		if (PreloadedClasses[Index]->IsChildOf<UGameplayAbility>())
+		{
+			const UGameplayAbility* AbilityCDO = PreloadedClasses[Index]->GetDefaultObject<UGameplayAbility>();
+			for (const UGameplayEffect* Effect : { AbilityCDO->GetCostGameplayEffect(), AbilityCDO->GetCooldownGameplayEffect() })
+			{
+				if (Effect)
+				{
+					PreloadedClasses.AddUnique(Effect->GetClass());
+				}
+			}
+		}
+	}
+
+	// Gameplay cues are only needed where they are played, and are looked up by tag through the cue manager
+	const ENetMode OwnerNetMode = GetOwner()->GetNetMode();
+	const UGameplayCueManager* CueManager = UAbilitySystemGlobals::Get().GetGameplayCueManager();
+	const UGameplayCueSet* CueSet = CueManager ? CueManager->GetRuntimeCueSet() : nullptr;
+
+	TSet<FSoftObjectPath> CuePaths;
+	if (CueSet && (GIsEditor || OwnerNetMode != NM_DedicatedServer))
+	{
+		for (const UClass* PreloadedClass : PreloadedClasses)
+		{
+			if (!PreloadedClass->IsChildOf<UGameplayEffect>())
+			{
+				continue;
+			}
+
+			for (const FGameplayEffectCue& Cue : PreloadedClass->GetDefaultObject<UGameplayEffect>()->GameplayCues)
+			{
+				for (const FGameplayTag& CueTag : Cue.GameplayCueTags)
+				{
+					if (const int32* CueIndex = CueSet->GameplayCueDataMap.Find(CueTag))
+					{
+						const FSoftObjectPath& CuePath = CueSet->GameplayCueData[*CueIndex].GameplayCueNotifyObj;
+						if (CuePath.IsValid())
+						{
+							CuePaths.Add(CuePath);
+						}
+					}
+				}
+			}
+		}
+	}
+
+	if (CuePaths.Num() == 0)
+	{
+		OnPreloadCompleted();
+		return;
+	}
+
+	PreloadHandle = UAssetManager::Get().LoadAssetList(CuePaths.Array(), FStreamableDelegate(), FStreamableManager::AsyncLoadHighPriority);
+	if (!PreloadHandle.IsValid() || PreloadHandle->HasLoadCompleted())
+	{
+		OnPreloadCompleted();
+	}
+	else
+	{
+		PreloadHandle->BindCompleteDelegate(FStreamableDelegate::CreateUObject(this, &ThisClass::OnPreloadCompleted));
+		PreloadHandle->BindCancelDelegate(FStreamableDelegate::CreateUObject(this, &ThisClass::OnPreloadCompleted));
+	}
+}
+
+void UExperienceManagerComponent::OnPreloadCompleted()
+{
+	if (LoadState != EExperienceLoadState::Preloading)
+	{
+		return;
+	}
+
+	if (PreloadHandle.IsValid())
+	{
+		TArray<UObject*> LoadedAssets;
+		PreloadHandle->GetLoadedAssets(LoadedAssets);
+		for (UObject* LoadedAsset : LoadedAssets)
+		{
+			if (UClass* LoadedClass = Cast<UClass>(LoadedAsset))
+			{
+				PreloadedClasses.AddUnique(LoadedClass);
+			}
+		}
+
+		PreloadHandle->ReleaseHandle();
+		PreloadHandle.Reset();
+	}
+
+	if (bConstructPreloadedDefaultObjects)
+	{
+		for (UClass* PreloadedClass : PreloadedClasses)
+		{
+			PreloadedClass->GetDefaultObject(true);
+		}
+	}
+
+	EXPERIENCE_NET_LOG(Log, this, TEXT("Preloaded %d gameplay classes for experience '%s' in %.2f seconds"),
+		PreloadedClasses.Num(), *CurrentExperience->GetPrimaryAssetId().ToString(), FPlatformTime::Seconds() - PreloadStartTime);
+
+	OnExperienceFullLoadCompleted();
+}
+
+TSharedPtr<const FExperienceInputConfigTable> UExperienceManagerComponent::GetInputConfigTable(const UExperiencePawnData* PawnData) const
+{
+	if (!IsExperienceLoaded() || PawnData == nullptr)
+	{
+		return nullptr;
+	}
+
+	// Not cached before the input config of the pawn data is in, or the table would miss its bindings
+	if (!PawnData->InputConfig.IsNull() && PawnData->InputConfig.Get() == nullptr)
+	{
+		return nullptr;
+	}
+
+	if (const TSharedRef<const FExperienceInputConfigTable>* Table = InputConfigTables.Find(PawnData))
+	{
+		return *Table;
+	}
+
+	return InputConfigTables.Add(PawnData, FExperienceInputConfigTable::Build(PawnData, InputConfigContributions));
+}
+
+void UExperienceManagerComponent::BuildInputConfigTables()
+{
+	InputConfigContributions.Reset();
+	InputConfigTables.Reset();
+
+	auto GatherInputConfigs = [this](const TArray<UGameFeatureAction*>& ActionList)
+	{
+		for (const UGameFeatureAction* Action : ActionList)
+		{
+			if (const UGameFeatureAction_AddInputConfig* InputConfigAction = Cast<UGameFeatureAction_AddInputConfig>(Action))
+			{
+				InputConfigContributions.Append(InputConfigAction->InputConfigs);
+			}
+		}
+	};
+
+	GatherInputConfigs(CurrentExperience->FeatureActions);
+	for (const TObjectPtr<UGameFeatureActionSet>& ActionSet : CurrentExperience->FeatureActionSets)
+	{
+		if (ActionSet != nullptr)
+		{
+			GatherInputConfigs(ActionSet->Actions);
+		}
+	}
+
+	// Only player pawns bind input, which dedicated servers don't have. Tables of other pawn data are built when first asked for.
+	if (GetOwner()->GetNetMode() != NM_DedicatedServer && CurrentExperience->DefaultPawnData.Get())
+	{
+		GetInputConfigTable(CurrentExperience->DefaultPawnData.Get());
 	}
 }
 
@@ -380,6 +789,109 @@ void UExperienceManagerComponent::OnAllActionsDeactivated()
 	CurrentExperience = nullptr;
 }
 
+void UExperienceManagerComponent::ResetExperienceActions(FSimpleDelegate OnResetComplete)
+{
+	check(IsExperienceLoaded());
+	check(!IsResettingExperienceActions());
+
+	// Only actions that opted in are re-run, everything else keeps its state
+	auto GatherResettableActions = [this](const TArray<UGameFeatureAction*>& ActionList)
+	{
+		for (UGameFeatureAction* Action : ActionList)
+		{
+			const IExperienceResettableAction* ResettableAction = Cast<IExperienceResettableAction>(Action);
+			if (ResettableAction && ResettableAction->ShouldResetOnMatchReset())
+			{
+				ResettingActions.Add(Action);
+			}
+		}
+	};
+
+	GatherResettableActions(CurrentExperience->FeatureActions);
+	for (const TObjectPtr<UGameFeatureActionSet>& ActionSet : CurrentExperience->FeatureActionSets)
+	{
+		if (ActionSet != nullptr)
+		{
+			GatherResettableActions(ActionSet->Actions);
+		}
+	}
+
+	if (ResettingActions.Num() == 0)
+	{
+		OnResetComplete.ExecuteIfBound();
+		return;
+	}
+
+	EXPERIENCE_NET_LOG(Log, this, TEXT("Resetting %d actions of experience '%s'"),
+		ResettingActions.Num(), *CurrentExperience->GetPrimaryAssetId().ToString());
+
+	OnResetActionsComplete = MoveTemp(OnResetComplete);
+
+	// Same as when the experience is deactivated, a pauser firing right away mustn't complete the reset prematurely
+	NumExpectedResetPausers = INDEX_NONE;
+	NumObservedResetPausers = 0;
+
+	FGameFeatureDeactivatingContext DeactivatingContext(TEXT(""), [WeakThis = TWeakObjectPtr<ThisClass>(this)](FStringView)
+	{
+		if (ThisClass* StrongThis = WeakThis.Get())
+		{
+			StrongThis->OnResetActionDeactivationCompleted();
+		}
+	});
+
+	if (const FWorldContext* WorldContext = GEngine->GetWorldContextFromWorld(GetWorld()))
+	{
+		DeactivatingContext.SetRequiredWorldContextHandle(WorldContext->ContextHandle);
+	}
+
+	for (UGameFeatureAction* Action : ResettingActions)
+	{
+		Action->OnGameFeatureDeactivating(DeactivatingContext);
+	}
+
+	NumExpectedResetPausers = DeactivatingContext.GetNumPausers();
+	if (NumExpectedResetPausers > 0)
+	{
+		EXPERIENCE_NET_LOG(Log, this, TEXT("Waiting for %d actions to finish deactivating before activating them again"), NumExpectedResetPausers);
+	}
+
+	if (NumExpectedResetPausers == NumObservedResetPausers)
+	{
+		ActivateResetActions();
+	}
+}
+
+void UExperienceManagerComponent::OnResetActionDeactivationCompleted()
+{
+	check(IsInGameThread());
+	++NumObservedResetPausers;
+
+	// The experience may have been torn down while the actions were deactivating
+	if (NumExpectedResetPausers == NumObservedResetPausers && IsResettingExperienceActions())
+	{
+		ActivateResetActions();
+	}
+}
+
+void UExperienceManagerComponent::ActivateResetActions()
+{
+	FGameFeatureActivatingContext ActivatingContext;
+	if (const FWorldContext* WorldContext = GEngine->GetWorldContextFromWorld(GetWorld()))
+	{
+		ActivatingContext.SetRequiredWorldContextHandle(WorldContext->ContextHandle);
+	}
+
+	const TArray<TObjectPtr<UGameFeatureAction>> Actions = MoveTemp(ResettingActions);
+	for (UGameFeatureAction* Action : Actions)
+	{
+		Action->OnGameFeatureActivating(ActivatingContext);
+	}
+
+	FSimpleDelegate OnComplete = MoveTemp(OnResetActionsComplete);
+	OnResetActionsComplete.Unbind();
+	OnComplete.ExecuteIfBound();
+}
+
 void UExperienceManagerComponent::OnExperienceFullLoadCompleted()
 {
 	check(LoadState != EExperienceLoadState::Loaded);
@@ -422,6 +934,19 @@ void UExperienceManagerComponent::OnExperienceFullLoadCompleted()
 
 	LoadState = EExperienceLoadState::Loaded;
 
+	BuildInputConfigTables();
+
+	// Input assets are client only, a dedicated server loading any means some pawn or action references them directly
+	// Not meaningful in the editor, which shares the process with the clients
+	if (ExperienceServerFootprint::bValidateOnLoad && !GIsEditor && GetOwner()->GetNetMode() == NM_DedicatedServer)
+	{
+		if (const int32 NumInputAssets = ExperienceServerFootprint::ReportLoadedInputAssets(*GLog))
+		{
+			EXPERIENCE_NET_LOG(Error, this, TEXT("Dedicated server has %d input assets loaded with experience '%s', see above"),
+				NumInputAssets, *CurrentExperience->GetPrimaryAssetId().ToString());
+		}
+	}
+
 	OnExperienceLoaded_HighPriority.Broadcast(CurrentExperience);
 	OnExperienceLoaded_HighPriority.Clear();
 
@@ -5,11 +5,15 @@
 
 #include "AbilitySystemComponent.h"
 #include "AbilitySystemGlobals.h"
+#include "ExperienceAssetManager.h"
 #include "ExperienceManagerSubsystem.h"
 #include "GameplayExperiencesLog.h"
 #include "ModularAbilitySystemComponent.h"
+#include "ModularAbilityTagRelationshipMapping.h"
+#include "Components/ExperienceInitStateMetrics.h"
 #include "Components/GameFrameworkComponentManager.h"
 #include "Developer/ExperienceGameSettings.h"
+#include "GameFramework/ExperiencePlayerState.h"
 #include "Net/UnrealNetwork.h"
 
 #include UE_INLINE_GENERATED_CPP_BY_NAME(ExperiencePawnExtensionComponent)
@@ -38,14 +42,28 @@ void UExperiencePawnExtensionComponent::BeginPlay()
 	// Listen for changes to all features
 	BindOnActorInitStateChanged(NAME_None, FGameplayTag(), false);
 
+	InitStartTime = FPlatformTime::Seconds();
+	StuckTracker.Begin(GetOwner());
+
 	// Notifies state manager that we've spawned, then try rest of default initialization
 	ensure(TryToChangeInitState(UExperienceManagerSubsystem::Get()->GetTag_Spawned()));
+
+	// Track the features we have to wait on, rather than re-checking all of them on every state change
+	if (UGameFrameworkComponentManager* Manager = UGameFrameworkComponentManager::GetForActor(GetOwner()))
+	{
+		InitStateCoordinator.Initialize(Manager, GetOwner(), NAME_ActorFeatureName, UExperienceManagerSubsystem::Get()->GetTag_Available());
+	}
+
 	CheckDefaultInitialization();
 }
 
 void UExperiencePawnExtensionComponent::EndPlay(const EEndPlayReason::Type EndPlayReason)
 {
+	// A destroyed pawn is usually replaced by the next one of the player, anything else (level unloading, the game ending) isn't
+	UninitializeAbilitySystem(EndPlayReason == EEndPlayReason::Destroyed);
+
 	UnregisterInitStateFeature();
+	StuckTracker.End();
 	
 	Super::EndPlay(EndPlayReason);
 }
@@ -70,36 +88,67 @@ void UExperiencePawnExtensionComponent::CheckDefaultInitialization()
 	// Before checking our progress, try progressing any other features we might depend on
 	CheckDefaultInitializationForImplementers();
 
+	// Forget about features that went away while we were waiting on them
+	if (UGameFrameworkComponentManager* Manager = UGameFrameworkComponentManager::GetForActor(GetOwner()))
+	{
+		InitStateCoordinator.Refresh(Manager, GetOwner());
+	}
+
 	// Try to progress from spawned (which is only set in BeginPlay) through the data initialization stages until it gets to gameplay ready
-	ContinueInitStateChain(UExperienceManagerSubsystem::Get()->StateChain);
+	ContinueInitStateChain(UExperienceManagerSubsystem::Get()->GetInitStateChain().GetStates());
 }
 
 bool UExperiencePawnExtensionComponent::CanChangeInitState(
 	UGameFrameworkComponentManager* Manager, FGameplayTag CurrentState, FGameplayTag DesiredState) const
 {
 	check(Manager);
+
+	const int32 Stage = UExperienceManagerSubsystem::Get()->GetInitStateChain().GetTransitionStage(CurrentState, DesiredState);
+	if (Stage == INDEX_NONE)
+	{
+		TRACE_EXPERIENCE_INIT_STATE(GetOwner(), NAME_ActorFeatureName, CurrentState, DesiredState, EExperienceInitStateReason::InvalidTransition);
+		EXPERIENCE_LOG(Warning, TEXT("Invalid transition from %s to %s"), *CurrentState.ToString(), *DesiredState.ToString());
+		return false;
+	}
+
+	return CanEnterInitStage(Manager, Stage);
+}
+
+bool UExperiencePawnExtensionComponent::CanEnterInitStage(UGameFrameworkComponentManager* Manager, int32 Stage) const
+{
 	APawn* Pawn = GetPawn<APawn>();
-	const UExperienceManagerSubsystem* ExpMgr = UExperienceManagerSubsystem::Get();
+	const FExperienceInitStateChain& Chain = UExperienceManagerSubsystem::Get()->GetInitStateChain();
 
+	// Refusals are traced and counted towards the stuck pawn summaries, nothing is formatted on this path
+	auto RefuseTransition = [&](EExperienceInitStateReason Reason, FName WaitingOn = NAME_None)
+	{
+		TRACE_EXPERIENCE_INIT_STATE(Pawn, NAME_ActorFeatureName, Chain.GetState(Stage - 1), Chain.GetState(Stage), Reason);
+		StuckTracker.NoteWaiting(WaitingOn, Reason);
+		return false;
+	};
+
+	switch (Stage)
+	{
 	// None -> Spawned
-	if (!CurrentState.IsValid() && DesiredState == ExpMgr->GetTag_Spawned())
+	case FExperienceInitStateChain::SpawnedStage:
 	{
 		// As long as we're on a valid pawn, we count as spawned
 		if (IsValid(Pawn))
 		{
-			EXPERIENCE_LOG(Log, TEXT("Transitioning from %s to %s"), *CurrentState.ToString(), *DesiredState.ToString());
 			return true;
 		}
+
+		TRACE_EXPERIENCE_INIT_STATE(Pawn, NAME_ActorFeatureName, Chain.GetState(Stage - 1), Chain.GetState(Stage), EExperienceInitStateReason::InvalidPawn);
+		return false;
 	}
 
 	// Spawned -> Available
-	if (CurrentState == ExpMgr->GetTag_Spawned() && DesiredState == ExpMgr->GetTag_Available())
+	case FExperienceInitStateChain::AvailableStage:
 	{
 		// Pawn data is required
 		if (PawnData == nullptr)
 		{
-			EXPERIENCE_LOG(Log, TEXT("PawnData is required to transition from %s to %s"), *CurrentState.ToString(), *DesiredState.ToString());
-			return false;
+			return RefuseTransition(EExperienceInitStateReason::MissingPawnData);
 		}
 
 		const bool bHasAuthority = Pawn->HasAuthority();
@@ -110,42 +159,37 @@ bool UExperiencePawnExtensionComponent::CanChangeInitState(
 			// Check for a valid controller
 			if (!GetController<AController>())
 			{
-				EXPERIENCE_LOG(Log, TEXT("No controller found to transition from %s to %s"), *CurrentState.ToString(), *DesiredState.ToString());
-				return false;
+				return RefuseTransition(EExperienceInitStateReason::MissingController);
 			}
 		}
 
-		EXPERIENCE_LOG(Log, TEXT("Transitioning from %s to %s"), *CurrentState.ToString(), *DesiredState.ToString());
 		return true;
 	}
 
 	// Available -> Initialized
-	if (CurrentState == ExpMgr->GetTag_Available() && DesiredState == ExpMgr->GetTag_Initialized())
+	case FExperienceInitStateChain::InitializedStage:
 	{
-		// Transition to initialize if all features have their data available
-		const bool bAllFeaturesAvailable = Manager->HaveAllFeaturesReachedInitState(Pawn, ExpMgr->GetTag_Available());
-
-		if (bAllFeaturesAvailable)
+		// Transition to initialize once all features have their data available
+		if (InitStateCoordinator.IsTracking())
 		{
-			EXPERIENCE_LOG(Log, TEXT("Transitioning from %s to %s"), *CurrentState.ToString(), *DesiredState.ToString());
+			if (!InitStateCoordinator.IsComplete())
+			{
+				return RefuseTransition(EExperienceInitStateReason::WaitingForFeatures, InitStateCoordinator.GetFirstPendingFeature());
+			}
 		}
-		else
+		else if (!Manager->HaveAllFeaturesReachedInitState(Pawn, Chain.GetState(FExperienceInitStateChain::AvailableStage)))
 		{
-			EXPERIENCE_LOG(Log, TEXT("Still waiting for all features to be available"));
+			// Nothing is tracked without a component manager at BeginPlay, walk every feature instead
+			return RefuseTransition(EExperienceInitStateReason::WaitingForFeatures);
 		}
 
-		return bAllFeaturesAvailable;
+		return true;
 	}
 
-	// Initialized -> Ready
-	if (CurrentState == ExpMgr->GetTag_Initialized() && DesiredState == ExpMgr->GetTag_Ready())
-	{
-		EXPERIENCE_LOG(Log, TEXT("Transitioning from %s to %s"), *CurrentState.ToString(), *DesiredState.ToString());
+	// Initialized -> project specific stages -> Ready
+	default:
 		return true;
 	}
-
-	EXPERIENCE_LOG(Warning, TEXT("Invalid transition from %s to %s"), *CurrentState.ToString(), *DesiredState.ToString());
-	return false;
 }
 
 void UExperiencePawnExtensionComponent::HandleChangeInitState(
@@ -154,15 +198,33 @@ void UExperiencePawnExtensionComponent::HandleChangeInitState(
 	// Nothing to do here.
 	// Will be handled by other components listening to the state
 
-	EXPERIENCE_LOG(Log, TEXT("---- CurrentState=%s --> DesiredState=%s"), *CurrentState.ToString(), *DesiredState.ToString());
+	const FExperienceInitStateChain& Chain = UExperienceManagerSubsystem::Get()->GetInitStateChain();
+	const int32 Stage = Chain.GetStage(DesiredState);
+
+	if (Stage == FExperienceInitStateChain::InitializedStage)
+	{
+		InitStateCoordinator.Finish();
+		StuckTracker.End();
+	}
+
+	TRACE_EXPERIENCE_INIT_STATE(GetOwner(), NAME_ActorFeatureName, CurrentState, DesiredState, EExperienceInitStateReason::Transitioned);
+
+	FExperienceInitStateMetrics::RecordStage(GetOwner(), NAME_ActorFeatureName, CurrentState, DesiredState, InitStateEnterTime);
+	if (Stage == Chain.GetReadyStage())
+	{
+		FExperienceInitStateMetrics::RecordTimeToReady(GetOwner(), InitStartTime);
+	}
+	InitStateEnterTime = FPlatformTime::Seconds();
+	EXPERIENCE_LOG(VeryVerbose, TEXT("---- CurrentState=%s --> DesiredState=%s"), *CurrentState.ToString(), *DesiredState.ToString());
 }
 
 void UExperiencePawnExtensionComponent::OnActorInitStateChanged(const FActorInitStateChangedParams& Params)
 {
-	// If any feature is now in DataAvailable, see if we should transition to DataInitialized
+	// Once the last feature we are waiting on is available, see if we should transition to DataInitialized
 	if (Params.FeatureName != NAME_ActorFeatureName)
 	{
-		if (Params.FeatureState == UExperienceManagerSubsystem::Get()->GetTag_Available())
+		UGameFrameworkComponentManager* Manager = UGameFrameworkComponentManager::GetForActor(GetOwner());
+		if (Manager && InitStateCoordinator.HandleFeatureStateChanged(Manager, Params))
 		{
 			CheckDefaultInitialization();
 		}
@@ -250,8 +312,12 @@ void UExperiencePawnExtensionComponent::InitializeAbilitySystem(UAbilitySystemCo
 	EXPERIENCE_LOG(Verbose, TEXT("Setting up ASC '%s' on pawn (%s) owner (%s), existing (%s)"),
 		*GetNameSafe(InASC), *GetNameSafe(Pawn), *GetNameSafe(InOwnerActor), *GetNameSafe(ExistingAvatar));
 
+	// The player state hands the ability system over from its previous pawn, rather than having it torn down in between
+	AExperiencePlayerState* HandoffPS = Cast<AExperiencePlayerState>(InOwnerActor);
+
 	if ((ExistingAvatar != nullptr) &&
-		(ExistingAvatar != Pawn))
+		(ExistingAvatar != Pawn) &&
+		!(HandoffPS && HandoffPS->IsAbilitySystemHandoffPendingFrom(ExistingAvatar)))
 	{
 		EXPERIENCE_LOG(Log, TEXT("Existing avatar (authority=%d"), ExistingAvatar->HasAuthority());
 
@@ -259,20 +325,33 @@ void UExperiencePawnExtensionComponent::InitializeAbilitySystem(UAbilitySystemCo
 		// Mostly happens on clients if they're lagging.
 		ensure(!ExistingAvatar->HasAuthority());
 
+		// This pawn takes over right away
 		if (UExperiencePawnExtensionComponent* OtherExtensionComp = FindPawnExtensionComponent(ExistingAvatar))
 		{
-			OtherExtensionComp->UninitializeAbilitySystem();
+			OtherExtensionComp->UninitializeAbilitySystem(true);
 		}
 	}
 
+	// Kicking out the existing avatar may just have started a handoff as well
+	const UExperiencePawnData* HandoffPawnData = nullptr;
+	const bool bWarmHandoff = HandoffPS && HandoffPS->ConsumeAbilitySystemHandoff(ExistingAvatar, HandoffPawnData);
+	const bool bSamePawnData = bWarmHandoff && HandoffPawnData == PawnData;
+
 	AbilitySystem = InASC;
+
+	// Cues of a different kind of pawn don't carry over
+	if (bWarmHandoff && !bSamePawnData)
+	{
+		AbilitySystem->RemoveAllGameplayCues();
+	}
+
 	AbilitySystem->InitAbilityActorInfo(InOwnerActor, Pawn);
 
-	if (ensure(PawnData))
+	if (ensure(PawnData) && !bSamePawnData)
 	{
 		if (UModularAbilitySystemComponent* ModularAbilitySystem = Cast<UModularAbilitySystemComponent>(AbilitySystem))
 		{
-			ModularAbilitySystem->SetTagRelationshipMapping(PawnData->TagRelationshipMapping);
+			ModularAbilitySystem->SetTagRelationshipMapping(UExperienceAssetManager::GetAsset(PawnData->TagRelationshipMapping, false));
 		}
 	}
 
@@ -287,7 +366,7 @@ void UExperiencePawnExtensionComponent::InitializeAbilitySystem(UAbilitySystemCo
 	OnAbilitySystemInitialized.Broadcast();
 }
 
-void UExperiencePawnExtensionComponent::UninitializeAbilitySystem()
+void UExperiencePawnExtensionComponent::UninitializeAbilitySystem(bool bHandOffToNextPawn)
 {
 	if (!AbilitySystem)
 	{
@@ -307,15 +386,25 @@ void UExperiencePawnExtensionComponent::UninitializeAbilitySystem()
 			ModularAbilitySystem->ClearAbilityInput();
 		}
 
-		AbilitySystem->RemoveAllGameplayCues();
-
-		if (AbilitySystem->GetOwnerActor() != nullptr)
+		// Nobody takes over once the player is gone
+		AExperiencePlayerState* HandoffPS = Cast<AExperiencePlayerState>(AbilitySystem->GetOwnerActor());
+		if (bHandOffToNextPawn && HandoffPS && HandoffPS->UsesWarmAbilitySystemHandoff() && HandoffPS->GetOwningController() != nullptr)
 		{
-			AbilitySystem->SetAvatarActor(nullptr);
+			// Leave the avatar and cues in place, the next pawn of the player takes over from here
+			HandoffPS->BeginAbilitySystemHandoff(GetPawn<APawn>(), PawnData);
 		}
 		else
 		{
-			AbilitySystem->ClearActorInfo();
+			AbilitySystem->RemoveAllGameplayCues();
+
+			if (AbilitySystem->GetOwnerActor() != nullptr)
+			{
+				AbilitySystem->SetAvatarActor(nullptr);
+			}
+			else
+			{
+				AbilitySystem->ClearActorInfo();
+			}
 		}
 
 		OnAbilitySystemUninitialized.Broadcast();
@@ -324,6 +413,29 @@ void UExperiencePawnExtensionComponent::UninitializeAbilitySystem()
 	AbilitySystem = nullptr;
 }
 
+bool UExperiencePawnExtensionComponent::ResetAbilitySystem()
+{
+	if (!AbilitySystem)
+	{
+		return true;
+	}
+
+	UAbilitySystemComponent* ASC = AbilitySystem;
+	AActor* OwnerActor = ASC->GetOwnerActor();
+	if (ASC->GetAvatarActor() != GetOwner() || OwnerActor == nullptr)
+	{
+		return false;
+	}
+
+	// Effects outlive the avatar, the damage and cooldowns of the previous round would carry over
+	ASC->RemoveActiveEffects(FGameplayEffectQuery());
+
+	UninitializeAbilitySystem();
+	InitializeAbilitySystem(ASC, OwnerActor);
+
+	return true;
+}
+
 void UExperiencePawnExtensionComponent::HandlePlayerStateReplicated()
 {
 	CheckDefaultInitialization();
@@ -9,11 +9,6 @@
 
 UExperienceGameSettings::UExperienceGameSettings()
 {
-	StateChain.Reserve(4);
-	StateChain.Add(FGameplayTag());
-	StateChain.Add(FGameplayTag());
-	StateChain.Add(FGameplayTag());
-	StateChain.Add(FGameplayTag());
 }
 
 UExperienceGameSettings* UExperienceGameSettings::Get()
@@ -2,10 +2,19 @@
 
 
 #include "ExperienceManagerSubsystem.h"
+#include "ExperienceDefinition.h"
+#include "ExperiencePawnData.h"
+#include "GameFeatureActionSet.h"
+#include "GameFeaturesSubsystem.h"
+#include "GameFeaturesSubsystemSettings.h"
+#include "Engine/AssetManager.h"
 #include "Engine/Engine.h"
 #include "Engine/World.h"
 #include "Engine/GameInstance.h"
+#include "Developer/ExperienceGameSettings.h"
+#include "ExperienceAssetManager.h"
 #include "GameplayExperiencesLog.h"
+#include "Misc/FileHelper.h"
 
 #include UE_INLINE_GENERATED_CPP_BY_NAME(ExperienceManagerSubsystem)
 
@@ -13,55 +22,703 @@ UExperienceManagerSubsystem::UExperienceManagerSubsystem()
 {
 }
 
+UExperienceManagerSubsystem* UExperienceManagerSubsystem::Instance = nullptr;
+
 UExperienceManagerSubsystem* UExperienceManagerSubsystem::Get()
 {
-	return GEngine->GetEngineSubsystem<UExperienceManagerSubsystem>();
+	return Instance ? Instance : GEngine->GetEngineSubsystem<UExperienceManagerSubsystem>();
+}
+
+void UExperienceManagerSubsystem::Initialize(FSubsystemCollectionBase& Collection)
+{
+	Super::Initialize(Collection);
+
+	Instance = this;
+
+	FString ChainError;
+	if (!InitStateChain.Compile(StateChain, ChainError))
+	{
+		EXPERIENCE_LOG(Error, TEXT("Invalid init state chain, pawns won't be able to initialize: %s"), *ChainError);
+	}
+
+	// Only dedicated servers wait for matchmaking, unless explicitly requested
+	const bool bWantsMatchAssignment = IsRunningDedicatedServer() || FParse::Param(FCommandLine::Get(), TEXT("WaitForMatchAssignment"));
+	const TSoftClassPtr<UExperienceMatchAssignmentProvider>& ProviderClass = UExperienceGameSettings::Get()->MatchAssignmentProviderClass;
+
+	if (bWantsMatchAssignment && !ProviderClass.IsNull())
+	{
+		if (UClass* LoadedProviderClass = ProviderClass.LoadSynchronous())
+		{
+			MatchAssignmentProvider = NewObject<UExperienceMatchAssignmentProvider>(this, LoadedProviderClass);
+			MatchAssignmentProvider->OnAssignmentReceived.AddUObject(this, &ThisClass::OnMatchAssignmentReceived);
+			MatchAssignmentProvider->StartListening();
+		}
+		else
+		{
+			EXPERIENCE_LOG(Error, TEXT("Failed to load match assignment provider class '%s'"), *ProviderClass.ToString());
+		}
+	}
+
+	if (ShouldWarmStart())
+	{
+		bWarmStartPending = true;
+		UAssetManager::CallOrRegister_OnCompletedInitialScan(FSimpleMulticastDelegate::FDelegate::CreateUObject(this, &ThisClass::BeginWarmStart));
+	}
+}
+
+void UExperienceManagerSubsystem::Deinitialize()
+{
+	if (MatchAssignmentProvider)
+	{
+		MatchAssignmentProvider->StopListening();
+		MatchAssignmentProvider->OnAssignmentReceived.RemoveAll(this);
+		MatchAssignmentProvider = nullptr;
+	}
+
+	PendingMatchAssignments.Empty();
+	ClaimedMatchAssignments.Empty();
+	MatchAssignmentWaiters.Empty();
+
+	for (const TPair<FPrimaryAssetId, FExperiencePrefetch>& Pair : Prefetches)
+	{
+		if (Pair.Value.ExperienceHandle.IsValid())
+		{
+			Pair.Value.ExperienceHandle->ReleaseHandle();
+		}
+		if (Pair.Value.BundleAssetHandle.IsValid())
+		{
+			Pair.Value.BundleAssetHandle->ReleaseHandle();
+		}
+		if (Pair.Value.RawAssetHandle.IsValid())
+		{
+			Pair.Value.RawAssetHandle->ReleaseHandle();
+		}
+	}
+	Prefetches.Empty();
+	MatchAssignmentPrefetches.Empty();
+
+	if (Instance == this)
+	{
+		Instance = nullptr;
+	}
+
+	Super::Deinitialize();
+}
+
+bool UExperienceManagerSubsystem::IsExpectingMatchAssignment(const UWorld* World) const
+{
+	return (MatchAssignmentProvider != nullptr) && !ClaimedMatchAssignments.Contains(World);
+}
+
+bool UExperienceManagerSubsystem::ClaimMatchAssignment(const UWorld* World, FExperienceMatchAssignment& OutAssignment)
+{
+	if (const FExperienceMatchAssignment* Claimed = ClaimedMatchAssignments.Find(World))
+	{
+		OutAssignment = *Claimed;
+		return true;
+	}
+
+	if (World == nullptr || PendingMatchAssignments.IsEmpty())
+	{
+		return false;
+	}
+
+	OutAssignment = PendingMatchAssignments[0];
+	PendingMatchAssignments.RemoveAt(0);
+	ClaimedMatchAssignments.Add(World, OutAssignment);
+
+	EXPERIENCE_LOG(Log, TEXT("Match assignment '%s' claimed by world '%s'"), *OutAssignment.MatchId, *GetNameSafe(World));
+	return true;
+}
+
+void UExperienceManagerSubsystem::ReleaseMatchAssignment(const UWorld* World)
+{
+	FExperienceMatchAssignment Assignment;
+	if (!ClaimedMatchAssignments.RemoveAndCopyValue(World, Assignment))
+	{
+		return;
+	}
+
+	EXPERIENCE_LOG(Log, TEXT("Match assignment '%s' released by world '%s'"), *Assignment.MatchId, *GetNameSafe(World));
+
+	if (!MatchAssignmentPrefetches.Contains(Assignment.ExperienceId))
+	{
+		return;
+	}
+
+	// Other matches of the same experience still benefit from the prefetch
+	const auto UsesSameExperience = [&Assignment](const FExperienceMatchAssignment& Other)
+	{
+		return Other.ExperienceId == Assignment.ExperienceId;
+	};
+
+	bool bStillNeeded = PendingMatchAssignments.ContainsByPredicate(UsesSameExperience);
+	for (const TPair<TObjectKey<UWorld>, FExperienceMatchAssignment>& Pair : ClaimedMatchAssignments)
+	{
+		bStillNeeded |= UsesSameExperience(Pair.Value);
+	}
+
+	if (!bStillNeeded)
+	{
+		MatchAssignmentPrefetches.Remove(Assignment.ExperienceId);
+		ReleasePrefetch(Assignment.ExperienceId);
+	}
+}
+
+FDelegateHandle UExperienceManagerSubsystem::CallOrRegister_OnMatchAssignmentReceived(FOnExperienceMatchAssignmentReceived::FDelegate&& Delegate)
+{
+	if (!PendingMatchAssignments.IsEmpty())
+	{
+		Delegate.Execute(PendingMatchAssignments[0]);
+		return FDelegateHandle();
+	}
+
+	const FDelegateHandle Handle(FDelegateHandle::GenerateNewHandle);
+	MatchAssignmentWaiters.Emplace(Handle, MoveTemp(Delegate));
+	return Handle;
+}
+
+void UExperienceManagerSubsystem::Unregister_OnMatchAssignmentReceived(FDelegateHandle Handle)
+{
+	MatchAssignmentWaiters.RemoveAll([Handle](const TPair<FDelegateHandle, FOnExperienceMatchAssignmentReceived::FDelegate>& Waiter)
+	{
+		return Waiter.Key == Handle;
+	});
+}
+
+void UExperienceManagerSubsystem::OnMatchAssignmentReceived(const FExperienceMatchAssignment& Assignment)
+{
+	// Providers keep listening for the next match, ignore a backend repeating itself
+	const auto IsSameMatch = [&Assignment](const FExperienceMatchAssignment& Other)
+	{
+		return !Assignment.MatchId.IsEmpty() && Other.MatchId == Assignment.MatchId;
+	};
+
+	bool bAlreadyKnown = PendingMatchAssignments.ContainsByPredicate(IsSameMatch);
+	for (const TPair<TObjectKey<UWorld>, FExperienceMatchAssignment>& Pair : ClaimedMatchAssignments)
+	{
+		bAlreadyKnown |= IsSameMatch(Pair.Value);
+	}
+
+	if (bAlreadyKnown)
+	{
+		EXPERIENCE_LOG(Verbose, TEXT("Ignoring match assignment '%s', it has already been received"), *Assignment.MatchId);
+		return;
+	}
+
+	PendingMatchAssignments.Add(Assignment);
+
+	// Get the expensive loading going while the map is still loading
+	if (UExperienceGameSettings::Get()->bPrefetchAssignedExperience && Assignment.ExperienceId.IsValid())
+	{
+		if (!Prefetches.Contains(Assignment.ExperienceId))
+		{
+			MatchAssignmentPrefetches.Add(Assignment.ExperienceId);
+		}
+
+		StartPrefetch(Assignment.ExperienceId);
+	}
+
+	DispatchMatchAssignments();
+}
+
+void UExperienceManagerSubsystem::DispatchMatchAssignments()
+{
+	// Every waiter is offered the oldest assignment once, a waiter that doesn't claim it has given up on waiting
+	while (!PendingMatchAssignments.IsEmpty() && !MatchAssignmentWaiters.IsEmpty())
+	{
+		FOnExperienceMatchAssignmentReceived::FDelegate Waiter = MoveTemp(MatchAssignmentWaiters[0].Value);
+		MatchAssignmentWaiters.RemoveAt(0);
+
+		Waiter.ExecuteIfBound(PendingMatchAssignments[0]);
+	}
+}
+
+void UExperienceManagerSubsystem::PrefetchExperience(const FPrimaryAssetId& ExperienceId)
+{
+	// Asked for explicitly, the prefetch stays resident even if a match assignment started it
+	MatchAssignmentPrefetches.Remove(ExperienceId);
+
+	StartPrefetch(ExperienceId);
+}
+
+void UExperienceManagerSubsystem::StartPrefetch(FPrimaryAssetId ExperienceId)
+{
+	if (!ExperienceId.IsValid() || Prefetches.Contains(ExperienceId))
+	{
+		return;
+	}
+
+	// Assignments can arrive before the asset manager is done with its initial scan, try again once it is
+	if (!UAssetManager::IsInitialized() || !UAssetManager::Get().HasInitialScanCompleted())
+	{
+		EXPERIENCE_LOG(Verbose, TEXT("Deferring prefetch of experience '%s' until the asset manager has been initialized"), *ExperienceId.ToString());
+		UAssetManager::CallOrRegister_OnCompletedInitialScan(FSimpleMulticastDelegate::FDelegate::CreateUObject(this, &ThisClass::StartPrefetch, ExperienceId));
+		return;
+	}
+
+	EXPERIENCE_LOG(Log, TEXT("Prefetching experience '%s'"), *ExperienceId.ToString());
+
+	FExperiencePrefetch& Prefetch = Prefetches.Add(ExperienceId);
+	Prefetch.StartTime = FPlatformTime::Seconds();
+	Prefetch.ExperienceHandle = UAssetManager::Get().LoadPrimaryAsset(ExperienceId, GetPrefetchBundles(), FStreamableDelegate(), FStreamableManager::AsyncLoadHighPriority);
+
+	const FStreamableDelegate OnLoadedDelegate = FStreamableDelegate::CreateUObject(this, &ThisClass::OnPrefetchedExperienceLoaded, ExperienceId);
+	if (!Prefetch.ExperienceHandle.IsValid() || Prefetch.ExperienceHandle->HasLoadCompleted())
+	{
+		OnPrefetchedExperienceLoaded(ExperienceId);
+	}
+	else
+	{
+		Prefetch.ExperienceHandle->BindCompleteDelegate(OnLoadedDelegate);
+		Prefetch.ExperienceHandle->BindCancelDelegate(OnLoadedDelegate);
+	}
+}
+
+bool UExperienceManagerSubsystem::IsExperiencePrefetched(const FPrimaryAssetId& ExperienceId) const
+{
+	const FExperiencePrefetch* Prefetch = Prefetches.Find(ExperienceId);
+	return Prefetch && Prefetch->bComplete;
+}
+
+void UExperienceManagerSubsystem::OnPrefetchedExperienceLoaded(FPrimaryAssetId ExperienceId)
+{
+	FExperiencePrefetch* Prefetch = Prefetches.Find(ExperienceId);
+	if (Prefetch == nullptr)
+	{
+		return;
+	}
+
+	UAssetManager& AssetManager = UAssetManager::Get();
+
+	const UClass* ExperienceClass = Cast<UClass>(AssetManager.GetPrimaryAssetPath(ExperienceId).ResolveObject());
+	const UExperienceDefinition* Experience = ExperienceClass ? GetDefault<UExperienceDefinition>(ExperienceClass) : nullptr;
+	if (Experience == nullptr)
+	{
+		EXPERIENCE_LOG(Error, TEXT("Prefetch of experience '%s' failed"), *ExperienceId.ToString());
+		CompletePrefetch(ExperienceId);
+		return;
+	}
+
+	// Hold an extra operation until everything has been kicked off, so nothing completing synchronously finishes the prefetch early
+	Prefetch->NumPendingOperations = 1;
+
+	// Action sets and pawn data carry their own bundles, the pawn data ones hold the pawn class and everything it spawns with
+	TArray<FPrimaryAssetId> BundleAssetIds;
+	for (const TObjectPtr<UGameFeatureActionSet>& ActionSet : Experience->FeatureActionSets)
+	{
+		if (ActionSet != nullptr)
+		{
+			BundleAssetIds.Add(ActionSet->GetPrimaryAssetId());
+		}
+	}
+
+	TArray<FSoftObjectPath> RawAssetPaths;
+	GetExperiencePawnData(Experience, BundleAssetIds, RawAssetPaths);
+
+	Prefetch->BundleAssetIds = BundleAssetIds;
+
+	const FStreamableDelegate OnAssetsLoaded = FStreamableDelegate::CreateUObject(this, &ThisClass::OnPrefetchOperationCompleted, ExperienceId);
+	auto TrackHandle = [Prefetch, &OnAssetsLoaded](const TSharedPtr<FStreamableHandle>& Handle)
+	{
+		if (Handle.IsValid() && !Handle->HasLoadCompleted())
+		{
+			++Prefetch->NumPendingOperations;
+			Handle->BindCompleteDelegate(OnAssetsLoaded);
+			Handle->BindCancelDelegate(OnAssetsLoaded);
+		}
+	};
+
+	if (BundleAssetIds.Num() > 0)
+	{
+		Prefetch->BundleAssetHandle = AssetManager.ChangeBundleStateForPrimaryAssets(BundleAssetIds, GetPrefetchBundles(), {}, false, FStreamableDelegate(), FStreamableManager::AsyncLoadHighPriority);
+		TrackHandle(Prefetch->BundleAssetHandle);
+	}
+
+	if (RawAssetPaths.Num() > 0)
+	{
+		Prefetch->RawAssetHandle = AssetManager.LoadAssetList(RawAssetPaths, FStreamableDelegate(), FStreamableManager::AsyncLoadHighPriority);
+		TrackHandle(Prefetch->RawAssetHandle);
+	}
+
+	// Get the plugins registered and loaded, activation is left to the experience manager component
+	// Loads can complete synchronously and anything listening may start another prefetch, so the entry is looked up again every time
+	for (const FGameFeaturePluginURL& Plugin : Experience->GameFeaturesToEnable)
+	{
+		FString PluginURL;
+		if (UGameFeaturesSubsystem::Get().GetPluginURLByName(Plugin.GetPluginName(), PluginURL))
+		{
+			Prefetch = Prefetches.Find(ExperienceId);
+			if (Prefetch == nullptr)
+			{
+				return;
+			}
+
+			++Prefetch->NumPendingOperations;
+			UGameFeaturesSubsystem::Get().LoadGameFeaturePlugin(PluginURL, FGameFeaturePluginLoadComplete::CreateUObject(this, &ThisClass::OnPrefetchPluginLoaded, ExperienceId));
+		}
+	}
+
+	OnPrefetchOperationCompleted(ExperienceId);
+}
+
+void UExperienceManagerSubsystem::OnPrefetchPluginLoaded(const UE::GameFeatures::FResult& Result, FPrimaryAssetId ExperienceId)
+{
+	OnPrefetchOperationCompleted(ExperienceId);
+}
+
+void UExperienceManagerSubsystem::OnPrefetchOperationCompleted(FPrimaryAssetId ExperienceId)
+{
+	FExperiencePrefetch* Prefetch = Prefetches.Find(ExperienceId);
+	if (Prefetch && !Prefetch->bComplete && --Prefetch->NumPendingOperations <= 0)
+	{
+		CompletePrefetch(ExperienceId);
+	}
+}
+
+void UExperienceManagerSubsystem::CompletePrefetch(FPrimaryAssetId ExperienceId)
+{
+	// Listeners may start other prefetches, don't hold on to the entry while broadcasting
+	double StartTime = 0.0;
+	{
+		FExperiencePrefetch& Prefetch = Prefetches.FindChecked(ExperienceId);
+		Prefetch.bComplete = true;
+		StartTime = Prefetch.StartTime;
+	}
+
+	EXPERIENCE_LOG(Log, TEXT("Prefetched experience '%s' in %.2fs"), *ExperienceId.ToString(), FPlatformTime::Seconds() - StartTime);
+
+	OnExperiencePrefetched.Broadcast(ExperienceId);
+}
+
+void UExperienceManagerSubsystem::ReleasePrefetch(const FPrimaryAssetId& ExperienceId)
+{
+	FExperiencePrefetch Prefetch;
+	if (!Prefetches.RemoveAndCopyValue(ExperienceId, Prefetch))
+	{
+		return;
+	}
+
+	// Canceling a handle still loading calls back into the prefetch, which is gone by now
+	for (const TSharedPtr<FStreamableHandle>& Handle : { Prefetch.ExperienceHandle, Prefetch.BundleAssetHandle, Prefetch.RawAssetHandle })
+	{
+		if (Handle.IsValid() && Handle->HasLoadCompleted())
+		{
+			Handle->ReleaseHandle();
+		}
+		else if (Handle.IsValid())
+		{
+			Handle->CancelHandle();
+		}
+	}
+
+	// Bundles a world acquired for its experience stay loaded for it
+	if (UAssetManager::IsInitialized())
+	{
+		TArray<FPrimaryAssetId> AssetIds = Prefetch.BundleAssetIds;
+		AssetIds.Add(ExperienceId);
+
+		const TArray<FName> PrefetchBundles = GetPrefetchBundles();
+		for (const FPrimaryAssetId& AssetId : AssetIds)
+		{
+			TArray<FName> BundlesToRemove;
+			for (const FName& Bundle : PrefetchBundles)
+			{
+				if (!BundleRefCounts.Contains(TPair<FPrimaryAssetId, FName>(AssetId, Bundle)))
+				{
+					BundlesToRemove.Add(Bundle);
+				}
+			}
+
+			if (BundlesToRemove.Num() > 0)
+			{
+				UAssetManager::Get().ChangeBundleStateForPrimaryAssets({ AssetId }, {}, BundlesToRemove);
+			}
+		}
+	}
+
+	EXPERIENCE_LOG(Log, TEXT("Released the prefetch of experience '%s'"), *ExperienceId.ToString());
+}
+
+void UExperienceManagerSubsystem::CallOrRegister_OnWarmStartComplete(FSimpleMulticastDelegate::FDelegate&& Delegate)
+{
+	if (IsWarmStartComplete())
+	{
+		Delegate.Execute();
+	}
+	else
+	{
+		OnWarmStartComplete.Add(MoveTemp(Delegate));
+	}
+}
+
+bool UExperienceManagerSubsystem::ShouldWarmStart()
+{
+	if (FParse::Param(FCommandLine::Get(), TEXT("ExperienceWarmStart")))
+	{
+		return true;
+	}
+
+	return IsRunningDedicatedServer() && UExperienceGameSettings::Get()->bWarmStartDedicatedServer;
+}
+
+void UExperienceManagerSubsystem::BeginWarmStart()
+{
+	const UExperienceGameSettings* Settings = UExperienceGameSettings::Get();
+
+	EXPERIENCE_LOG(Log, TEXT("Beginning experience warm start"));
+	WarmStartBeginTime = FPlatformTime::Seconds();
+
+	// Game data is loaded synchronously, nothing else is going on yet anyway
+	if (Settings->bWarmStartGameData && !Settings->GameDataPath.IsNull())
+	{
+		if (UExperienceAssetManager* ExperienceAssetManager = Cast<UExperienceAssetManager>(&UAssetManager::Get()))
+		{
+			ExperienceAssetManager->GetGameData();
+		}
+	}
+
+	TArray<FPrimaryAssetId> ExperienceIds = Settings->WarmStartExperiences;
+	if (ExperienceIds.IsEmpty())
+	{
+		ExperienceIds.Add(Settings->DefaultExperience);
+	}
+
+	OnExperiencePrefetched.AddUObject(this, &ThisClass::OnWarmStartExperiencePrefetched);
+
+	for (const FPrimaryAssetId& ExperienceId : ExperienceIds)
+	{
+		if (ExperienceId.IsValid() && !IsExperiencePrefetched(ExperienceId))
+		{
+			PendingWarmStartExperiences.Add(ExperienceId);
+		}
+	}
+
+	for (const FPrimaryAssetId& ExperienceId : PendingWarmStartExperiences.Array())
+	{
+		PrefetchExperience(ExperienceId);
+	}
+
+	if (PendingWarmStartExperiences.IsEmpty())
+	{
+		CompleteWarmStart();
+	}
+}
+
+void UExperienceManagerSubsystem::OnWarmStartExperiencePrefetched(const FPrimaryAssetId& ExperienceId)
+{
+	if (PendingWarmStartExperiences.Remove(ExperienceId) > 0 && PendingWarmStartExperiences.IsEmpty())
+	{
+		CompleteWarmStart();
+	}
+}
+
+void UExperienceManagerSubsystem::CompleteWarmStart()
+{
+	if (!bWarmStartPending)
+	{
+		return;
+	}
+
+	bWarmStartPending = false;
+	OnExperiencePrefetched.RemoveAll(this);
+
+	EXPERIENCE_LOG(Display, TEXT("Experience warm start completed in %.2fs, server is ready"), FPlatformTime::Seconds() - WarmStartBeginTime);
+
+	// Let an external orchestrator know without it having to parse logs
+	FString ReadyFilePath;
+	if (FParse::Value(FCommandLine::Get(), TEXT("ExperienceWarmStartReadyFile="), ReadyFilePath))
+	{
+		FFileHelper::SaveStringToFile(TEXT("Ready"), *ReadyFilePath);
+	}
+
+	OnWarmStartComplete.Broadcast();
+	OnWarmStartComplete.Clear();
+}
+
+void UExperienceManagerSubsystem::GetExperiencePawnData(const UExperienceDefinition* Experience, TArray<FPrimaryAssetId>& OutPrimaryAssetIds, TArray<FSoftObjectPath>& OutUnregisteredPaths)
+{
+	check(Experience);
+
+	for (const TSoftObjectPtr<UExperiencePawnData>& PawnData : { Experience->DefaultPawnData, Experience->BotFillSettings.BotPawnData })
+	{
+		if (PawnData.IsNull())
+		{
+			continue;
+		}
+
+		const FPrimaryAssetId PawnDataId = UAssetManager::Get().GetPrimaryAssetIdForPath(PawnData.ToSoftObjectPath());
+		if (PawnDataId.IsValid())
+		{
+			OutPrimaryAssetIds.AddUnique(PawnDataId);
+		}
+		else
+		{
+			EXPERIENCE_LOG(Error, TEXT("Pawn data '%s' of experience '%s' isn't a primary asset known to the asset manager, add its type to the primary asset types to scan. It is loaded without its bundles until then."),
+				*PawnData.ToString(), *GetNameSafe(Experience));
+			OutUnregisteredPaths.AddUnique(PawnData.ToSoftObjectPath());
+		}
+	}
+}
+
+TArray<FName> UExperienceManagerSubsystem::GetPrefetchBundles()
+{
+	TArray<FName> Bundles;
+	Bundles.Add("Equipped");
+
+	if (!IsRunningDedicatedServer())
+	{
+		Bundles.Add(UGameFeaturesSubsystemSettings::LoadStateClient);
+	}
+	if (!IsRunningClientOnly())
+	{
+		Bundles.Add(UGameFeaturesSubsystemSettings::LoadStateServer);
+	}
+
+	return Bundles;
 }
 
 #if WITH_EDITOR
 void UExperienceManagerSubsystem::OnPlayInEditorBegun()
 {
-	ensure(GameFeaturePluginRequestCountMap.IsEmpty());
-	GameFeaturePluginRequestCountMap.Empty();
+	ensure(GameFeaturePluginRequests.IsEmpty());
+	GameFeaturePluginRequests.Empty();
 }
+#endif
 
-void UExperienceManagerSubsystem::NotifyOfPluginActivation(const FString PluginURL)
+void UExperienceManagerSubsystem::NotifyOfPluginActivation(const FString PluginURL, const UObject* Requester)
 {
-	if (GIsEditor)
+	UExperienceManagerSubsystem* MutableThis = Get();
+	check(MutableThis);
+
+	// Track the number of requesters who have requested this plugin to be activated
+	FPluginRequests& Requests = MutableThis->GameFeaturePluginRequests.FindOrAdd(PluginURL);
+	++Requests.CountPerRequester.FindOrAdd(Requester);
+	++Requests.TotalCount;
+
+	EXPERIENCE_LOG(Log, TEXT("Request to activate plugin '%s' from %s (new listeners count %d)"), *PluginURL, *GetPathNameSafe(Requester), Requests.TotalCount);
+}
+
+bool UExperienceManagerSubsystem::RequestToDeactivatePlugin(const FString PluginURl, const UObject* Requester)
+{
+	UExperienceManagerSubsystem* MutableThis = Get();
+	check(MutableThis);
+
+	FPluginRequests* Requests = MutableThis->GameFeaturePluginRequests.Find(PluginURl);
+	if (Requests == nullptr)
 	{
-		UExperienceManagerSubsystem* MutableThis = GEngine->GetEngineSubsystem<UExperienceManagerSubsystem>();
-		check(MutableThis);
+		// Nobody is tracked as requesting it (anymore)
+		return true;
+	}
 
-		// Track the number of requesters who have requested this plugin to be activated
-		int32& Count = MutableThis->GameFeaturePluginRequestCountMap.FindOrAdd(PluginURL);
-		++Count;
+	// Only let the last requester to get this far deactivate the plugin
+	if (int32* RequesterCount = Requests->CountPerRequester.Find(Requester))
+	{
+		--Requests->TotalCount;
+		if (--(*RequesterCount) == 0)
+		{
+			Requests->CountPerRequester.Remove(Requester);
+		}
+	}
 
-		EXPERIENCE_LOG(Log, TEXT("Request to activate plugin '%s' (new listeners count %d)"), *PluginURL, Count);
+	if (Requests->TotalCount <= 0)
+	{
+		EXPERIENCE_LOG(Log, TEXT("No more requests for plugin '%s', deactivating."), *PluginURl);
+		MutableThis->GameFeaturePluginRequests.Remove(PluginURl);
+		return true;
 	}
+
+	return false;
 }
 
-bool UExperienceManagerSubsystem::RequestToDeactivatePlugin(const FString PluginURl)
+bool UExperienceManagerSubsystem::ReleasePluginRequests(const FString& PluginURL, const UObject* Requester)
 {
-	if (GIsEditor)
+	UExperienceManagerSubsystem* MutableThis = Get();
+	check(MutableThis);
+
+	FPluginRequests* Requests = MutableThis->GameFeaturePluginRequests.Find(PluginURL);
+	if (Requests == nullptr)
+	{
+		return true;
+	}
+
+	int32 RequesterCount = 0;
+	if (Requests->CountPerRequester.RemoveAndCopyValue(Requester, RequesterCount))
 	{
-		UExperienceManagerSubsystem* MutableThis = GEngine->GetEngineSubsystem<UExperienceManagerSubsystem>();
-		check(MutableThis);
+		Requests->TotalCount -= RequesterCount;
+	}
+
+	if (Requests->TotalCount <= 0)
+	{
+		EXPERIENCE_LOG(Log, TEXT("No more requests for plugin '%s', deactivating."), *PluginURL);
+		MutableThis->GameFeaturePluginRequests.Remove(PluginURL);
+		return true;
+	}
 
-		// Only let the last requester to get this far deactivate the plugin
-		int32& Count = MutableThis->GameFeaturePluginRequestCountMap.FindChecked(PluginURl);
-		--Count;
+	EXPERIENCE_LOG(Log, TEXT("Plugin '%s' released by %s but still requested by others (listeners count %d)."), *PluginURL, *GetPathNameSafe(Requester), Requests->TotalCount);
+	return false;
+}
 
-		if (Count == 0)
+TSharedPtr<FStreamableHandle> UExperienceManagerSubsystem::AcquireExperienceBundles(const UWorld* World, const FPrimaryAssetId& ExperienceId, const TArray<FPrimaryAssetId>& AssetIds, const TArray<FName>& Bundles)
+{
+	// Take the new references before dropping the old ones, so bundles shared by both stay put
+	for (const FPrimaryAssetId& AssetId : AssetIds)
+	{
+		for (const FName& Bundle : Bundles)
 		{
-			EXPERIENCE_LOG(Log, TEXT("No more requests for plugin '%s', deactivating."), *PluginURl);
-			MutableThis->GameFeaturePluginRequestCountMap.Remove(PluginURl);
-			return true;
+			++BundleRefCounts.FindOrAdd(TPair<FPrimaryAssetId, FName>(AssetId, Bundle));
 		}
+	}
 
-		return false;
+	ReleaseExperienceBundles(World);
+
+	FWorldExperience& WorldExperience = WorldExperiences.Add(World);
+	WorldExperience.ExperienceId = ExperienceId;
+	WorldExperience.AssetIds = AssetIds;
+	WorldExperience.Bundles = Bundles;
+
+	EXPERIENCE_LOG(Log, TEXT("%s acquired the bundles of experience '%s' (%d experiences hosted)"), *GetNameSafe(World), *ExperienceId.ToString(), WorldExperiences.Num());
+
+	if (AssetIds.Num() == 0)
+	{
+		return nullptr;
 	}
 
-	return true;
+	// Adding bundles is additive, so this only has to wait on what no other world loaded already
+	return UAssetManager::Get().ChangeBundleStateForPrimaryAssets(AssetIds, Bundles, {}, false, FStreamableDelegate(), FStreamableManager::AsyncLoadHighPriority);
 }
 
-#endif
\ No newline at end of file
+void UExperienceManagerSubsystem::ReleaseExperienceBundles(const UWorld* World)
+{
+	FWorldExperience WorldExperience;
+	if (!WorldExperiences.RemoveAndCopyValue(World, WorldExperience))
+	{
+		return;
+	}
+
+	// Prefetched experiences are meant to stay resident
+	const bool bKeepResident = Prefetches.Contains(WorldExperience.ExperienceId);
+
+	UAssetManager* AssetManager = UAssetManager::IsInitialized() ? &UAssetManager::Get() : nullptr;
+	for (const FPrimaryAssetId& AssetId : WorldExperience.AssetIds)
+	{
+		TArray<FName> BundlesToRemove;
+		for (const FName& Bundle : WorldExperience.Bundles)
+		{
+			const TPair<FPrimaryAssetId, FName> Key(AssetId, Bundle);
+			int32* RefCount = BundleRefCounts.Find(Key);
+			if (RefCount && --(*RefCount) <= 0)
+			{
+				BundleRefCounts.Remove(Key);
+				BundlesToRemove.Add(Bundle);
+			}
+		}
+
+		if (AssetManager && !bKeepResident && BundlesToRemove.Num() > 0)
+		{
+			AssetManager->ChangeBundleStateForPrimaryAssets({ AssetId }, {}, BundlesToRemove);
+		}
+	}
+
+	EXPERIENCE_LOG(Log, TEXT("%s released the bundles of experience '%s' (%d experiences hosted)"), *GetNameSafe(World), *WorldExperience.ExperienceId.ToString(), WorldExperiences.Num());
+}
@@ -9,6 +9,4 @@
 UExperiencePawnData::UExperiencePawnData(const FObjectInitializer& ObjectInitializer)
 	: Super(ObjectInitializer)
 {
-	PawnClass = nullptr;
-	InputConfig = nullptr;
 }
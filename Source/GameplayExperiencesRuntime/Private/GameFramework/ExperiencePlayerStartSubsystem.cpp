@@ -0,0 +1,455 @@
+// Copyright © 2024 Playton. All Rights Reserved.
+
+
+#include "GameFramework/ExperiencePlayerStartSubsystem.h"
+
+#include "EngineUtils.h"
+#include "GameplayExperiencesLog.h"
+#include "GenericTeamAgentInterface.h"
+#include "Engine/Level.h"
+#include "Engine/World.h"
+#include "GameFramework/PlayerStart.h"
+
+#include UE_INLINE_GENERATED_CPP_BY_NAME(ExperiencePlayerStartSubsystem)
+
+namespace ExperiencePlayerStarts
+{
+	FIntVector GetCell(const FVector& Location, float CellSize)
+	{
+		return FIntVector(
+			FMath::FloorToInt32(Location.X / CellSize),
+			FMath::FloorToInt32(Location.Y / CellSize),
+			FMath::FloorToInt32(Location.Z / CellSize));
+	}
+}
+
+UExperiencePlayerStartSubsystem::UExperiencePlayerStartSubsystem()
+{
+}
+
+void UExperiencePlayerStartSubsystem::Initialize(FSubsystemCollectionBase& Collection)
+{
+	Super::Initialize(Collection);
+
+	LevelAddedHandle = FWorldDelegates::LevelAddedToWorld.AddUObject(this, &ThisClass::OnLevelAddedToWorld);
+	LevelRemovedHandle = FWorldDelegates::LevelRemovedFromWorld.AddUObject(this, &ThisClass::OnLevelRemovedFromWorld);
+}
+
+void UExperiencePlayerStartSubsystem::Deinitialize()
+{
+	FWorldDelegates::LevelAddedToWorld.Remove(LevelAddedHandle);
+	FWorldDelegates::LevelRemovedFromWorld.Remove(LevelRemovedHandle);
+
+	ResetIndex();
+
+	Super::Deinitialize();
+}
+
+bool UExperiencePlayerStartSubsystem::DoesSupportWorldType(const EWorldType::Type WorldType) const
+{
+	return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
+
+void UExperiencePlayerStartSubsystem::BuildIndex(const FExperiencePlayerStartSettings& InSettings)
+{
+	ResetIndex();
+
+	Settings = InSettings;
+	GridCellSize = FMath::Max(Settings.OccupancyRadius, 100.f);
+	bIndexBuilt = true;
+
+	for (TActorIterator<APlayerStart> It(GetWorld()); It; ++It)
+	{
+		AddPlayerStart(*It);
+	}
+
+	EXPERIENCE_LOG(Log, TEXT("Indexed %d player starts in %d team buckets for world '%s'"), EntryLookup.Num(), Buckets.Num(), *GetNameSafe(GetWorld()));
+}
+
+void UExperiencePlayerStartSubsystem::ResetIndex()
+{
+	Entries.Reset();
+	Buckets.Reset();
+	BucketLookup.Reset();
+	EntryLookup.Reset();
+	Grid.Reset();
+	Claims.Reset();
+	ClaimsHead = 0;
+	LastClaimByController.Reset();
+	bIndexBuilt = false;
+}
+
+APlayerStart* UExperiencePlayerStartSubsystem::ClaimPlayerStart(const AController* Controller, uint8 TeamId)
+{
+	if (!bIndexBuilt)
+	{
+		return nullptr;
+	}
+
+	ProcessExpiredClaims(GetWorld()->GetTimeSeconds());
+
+	// Candidates are the starts of the controller's team and the starts nobody owns
+	int32 CandidateBuckets[2] = { INDEX_NONE, INDEX_NONE };
+	if (const int32* TeamBucket = BucketLookup.Find(TeamId))
+	{
+		CandidateBuckets[0] = *TeamBucket;
+	}
+	if (TeamId != NoTeamId)
+	{
+		if (const int32* NoTeamBucket = BucketLookup.Find(NoTeamId))
+		{
+			CandidateBuckets[1] = *NoTeamBucket;
+		}
+	}
+
+	for (const int32 BucketIndex : CandidateBuckets)
+	{
+		if (BucketIndex == INDEX_NONE)
+		{
+			continue;
+		}
+
+		FBucket& Bucket = Buckets[BucketIndex];
+		while (Bucket.FreeEntries.Num() > 0)
+		{
+			const int32 EntryIndex = Bucket.FreeEntries[FMath::RandHelper(Bucket.FreeEntries.Num())];
+			FEntry& Entry = Entries[EntryIndex];
+
+			APlayerStart* PlayerStart = Entry.PlayerStart.Get();
+			if (PlayerStart == nullptr)
+			{
+				// Destroyed without its level being removed, drop it
+				for (auto It = EntryLookup.CreateIterator(); It; ++It)
+				{
+					if (It.Value() == EntryIndex)
+					{
+						It.RemoveCurrent();
+						break;
+					}
+				}
+
+				RemoveEntry(EntryIndex);
+				continue;
+			}
+
+			Entry.Occupant.Reset();
+
+			BlockEntry(EntryIndex);
+			for (const int32 NeighbourIndex : Entry.Neighbours)
+			{
+				BlockEntry(NeighbourIndex);
+			}
+
+			FClaim& Claim = Claims.AddDefaulted_GetRef();
+			Claim.EntryIndex = EntryIndex;
+			Claim.ReleaseTime = GetWorld()->GetTimeSeconds() + Settings.ClaimCooldown;
+
+			if (Controller)
+			{
+				LastClaimByController.Add(Controller, EntryIndex);
+			}
+
+			return PlayerStart;
+		}
+	}
+
+	EXPERIENCE_LOG(Verbose, TEXT("No free player start for team %d (controller %s)"), TeamId, *GetNameSafe(Controller));
+	return nullptr;
+}
+
+void UExperiencePlayerStartSubsystem::ReleaseClaim(const AController* Controller)
+{
+	int32 EntryIndex = INDEX_NONE;
+	if (!LastClaimByController.RemoveAndCopyValue(Controller, EntryIndex))
+	{
+		return;
+	}
+
+	// A start is claimed at most once at a time, and the claim was made recently so it is near the back of the queue
+	for (int32 Idx = Claims.Num() - 1; Idx >= ClaimsHead; --Idx)
+	{
+		if (Claims[Idx].EntryIndex != EntryIndex)
+		{
+			continue;
+		}
+
+		Claims.RemoveAt(Idx, 1, EAllowShrinking::No);
+
+		FEntry& Entry = Entries[EntryIndex];
+		Entry.Occupant.Reset();
+
+		UnblockEntry(EntryIndex);
+		for (const int32 NeighbourIndex : Entry.Neighbours)
+		{
+			UnblockEntry(NeighbourIndex);
+		}
+		break;
+	}
+}
+
+void UExperiencePlayerStartSubsystem::SetClaimOccupant(const AController* Controller, const APawn* Pawn)
+{
+	int32 EntryIndex = INDEX_NONE;
+	if (LastClaimByController.RemoveAndCopyValue(Controller, EntryIndex) && Entries.IsValidIndex(EntryIndex))
+	{
+		Entries[EntryIndex].Occupant = Pawn;
+	}
+}
+
+void UExperiencePlayerStartSubsystem::ReleaseAllClaims()
+{
+	for (int32 Idx = ClaimsHead; Idx < Claims.Num(); ++Idx)
+	{
+		FEntry& Entry = Entries[Claims[Idx].EntryIndex];
+		Entry.Occupant.Reset();
+
+		UnblockEntry(Claims[Idx].EntryIndex);
+		for (const int32 NeighbourIndex : Entry.Neighbours)
+		{
+			UnblockEntry(NeighbourIndex);
+		}
+	}
+
+	Claims.Reset();
+	ClaimsHead = 0;
+	LastClaimByController.Reset();
+}
+
+void UExperiencePlayerStartSubsystem::ProcessExpiredClaims(double Now)
+{
+	const double OccupancyRadiusSquared = FMath::Square(Settings.OccupancyRadius);
+
+	// Claims all share the same cooldown, so the queue is ordered by release time and only the head needs to be checked
+	while (ClaimsHead < Claims.Num() && Claims[ClaimsHead].ReleaseTime <= Now)
+	{
+		const int32 EntryIndex = Claims[ClaimsHead].EntryIndex;
+		++ClaimsHead;
+
+		FEntry& Entry = Entries[EntryIndex];
+
+		// Keep the start blocked as long as the pawn spawned there hasn't moved away
+		const APawn* Occupant = Entry.Occupant.Get();
+		if (IsValid(Occupant) && FVector::DistSquared(Occupant->GetActorLocation(), Entry.Location) < OccupancyRadiusSquared)
+		{
+			FClaim& Claim = Claims.AddDefaulted_GetRef();
+			Claim.EntryIndex = EntryIndex;
+			Claim.ReleaseTime = Now + FMath::Max(Settings.ClaimCooldown, UE_KINDA_SMALL_NUMBER);
+			continue;
+		}
+
+		Entry.Occupant.Reset();
+
+		UnblockEntry(EntryIndex);
+		for (const int32 NeighbourIndex : Entry.Neighbours)
+		{
+			UnblockEntry(NeighbourIndex);
+		}
+	}
+
+	// Compact the queue once the consumed part dominates it
+	if (ClaimsHead > 32 && ClaimsHead * 2 > Claims.Num())
+	{
+		Claims.RemoveAt(0, ClaimsHead, EAllowShrinking::No);
+		ClaimsHead = 0;
+	}
+}
+
+void UExperiencePlayerStartSubsystem::BlockEntry(int32 EntryIndex)
+{
+	FEntry& Entry = Entries[EntryIndex];
+	if (Entry.NumBlockers++ == 0)
+	{
+		RemoveFromFreeList(EntryIndex);
+	}
+}
+
+void UExperiencePlayerStartSubsystem::UnblockEntry(int32 EntryIndex)
+{
+	FEntry& Entry = Entries[EntryIndex];
+	check(Entry.NumBlockers > 0);
+
+	if (--Entry.NumBlockers == 0)
+	{
+		AddToFreeList(EntryIndex);
+	}
+}
+
+void UExperiencePlayerStartSubsystem::AddToFreeList(int32 EntryIndex)
+{
+	FEntry& Entry = Entries[EntryIndex];
+	if (Entry.bRemoved || Entry.FreeSlot != INDEX_NONE || Entry.NumBlockers > 0)
+	{
+		return;
+	}
+
+	Entry.FreeSlot = Buckets[Entry.BucketIndex].FreeEntries.Add(EntryIndex);
+}
+
+void UExperiencePlayerStartSubsystem::RemoveFromFreeList(int32 EntryIndex)
+{
+	FEntry& Entry = Entries[EntryIndex];
+	if (Entry.FreeSlot == INDEX_NONE)
+	{
+		return;
+	}
+
+	TArray<int32>& FreeEntries = Buckets[Entry.BucketIndex].FreeEntries;
+	FreeEntries.RemoveAtSwap(Entry.FreeSlot, 1, EAllowShrinking::No);
+	if (FreeEntries.IsValidIndex(Entry.FreeSlot))
+	{
+		Entries[FreeEntries[Entry.FreeSlot]].FreeSlot = Entry.FreeSlot;
+	}
+
+	Entry.FreeSlot = INDEX_NONE;
+}
+
+void UExperiencePlayerStartSubsystem::OnLevelAddedToWorld(ULevel* Level, UWorld* World)
+{
+	if (!bIndexBuilt || World != GetWorld() || Level == nullptr)
+	{
+		return;
+	}
+
+	for (AActor* Actor : Level->Actors)
+	{
+		if (APlayerStart* PlayerStart = Cast<APlayerStart>(Actor))
+		{
+			AddPlayerStart(PlayerStart);
+		}
+	}
+}
+
+void UExperiencePlayerStartSubsystem::OnLevelRemovedFromWorld(ULevel* Level, UWorld* World)
+{
+	if (!bIndexBuilt || World != GetWorld() || Level == nullptr)
+	{
+		return;
+	}
+
+	for (AActor* Actor : Level->Actors)
+	{
+		if (APlayerStart* PlayerStart = Cast<APlayerStart>(Actor))
+		{
+			RemovePlayerStart(PlayerStart);
+		}
+	}
+}
+
+void UExperiencePlayerStartSubsystem::AddPlayerStart(APlayerStart* PlayerStart)
+{
+	if (!IsValid(PlayerStart) || EntryLookup.Contains(PlayerStart))
+	{
+		return;
+	}
+
+	if (Settings.AllowedPlayerStartTags.Num() > 0 && !Settings.AllowedPlayerStartTags.Contains(PlayerStart->PlayerStartTag))
+	{
+		return;
+	}
+
+	const int32 EntryIndex = Entries.AddDefaulted();
+	FEntry& Entry = Entries[EntryIndex];
+	Entry.PlayerStart = PlayerStart;
+	Entry.Location = PlayerStart->GetActorLocation();
+	Entry.BucketIndex = FindOrAddBucket(GetTeamIdForPlayerStart(PlayerStart));
+
+	// Link up with the starts close enough to overlap a pawn spawned on either of them
+	const double OccupancyRadiusSquared = FMath::Square(Settings.OccupancyRadius);
+	const FIntVector Cell = ExperiencePlayerStarts::GetCell(Entry.Location, GridCellSize);
+	for (int32 X = -1; X <= 1; ++X)
+	{
+		for (int32 Y = -1; Y <= 1; ++Y)
+		{
+			for (int32 Z = -1; Z <= 1; ++Z)
+			{
+				if (const TArray<int32>* CellEntries = Grid.Find(Cell + FIntVector(X, Y, Z)))
+				{
+					for (const int32 OtherIndex : *CellEntries)
+					{
+						FEntry& Other = Entries[OtherIndex];
+						if (!Other.bRemoved && FVector::DistSquared(Other.Location, Entry.Location) < OccupancyRadiusSquared)
+						{
+							Other.Neighbours.Add(EntryIndex);
+							Entry.Neighbours.Add(OtherIndex);
+						}
+					}
+				}
+			}
+		}
+	}
+
+	Grid.FindOrAdd(Cell).Add(EntryIndex);
+	EntryLookup.Add(PlayerStart, EntryIndex);
+
+	// Inherit the blocks of any claimed neighbour
+	for (const int32 NeighbourIndex : Entry.Neighbours)
+	{
+		if (Entries[NeighbourIndex].NumBlockers > 0)
+		{
+			for (int32 Idx = ClaimsHead; Idx < Claims.Num(); ++Idx)
+			{
+				if (Claims[Idx].EntryIndex == NeighbourIndex)
+				{
+					++Entry.NumBlockers;
+				}
+			}
+		}
+	}
+
+	AddToFreeList(EntryIndex);
+}
+
+void UExperiencePlayerStartSubsystem::RemovePlayerStart(APlayerStart* PlayerStart)
+{
+	int32 EntryIndex = INDEX_NONE;
+	if (!EntryLookup.RemoveAndCopyValue(PlayerStart, EntryIndex))
+	{
+		return;
+	}
+
+	RemoveEntry(EntryIndex);
+}
+
+void UExperiencePlayerStartSubsystem::RemoveEntry(int32 EntryIndex)
+{
+	// Keep the slot so neighbour and claim indices stay valid, it just won't be handed out anymore
+	RemoveFromFreeList(EntryIndex);
+	Entries[EntryIndex].bRemoved = true;
+
+	if (TArray<int32>* CellEntries = Grid.Find(ExperiencePlayerStarts::GetCell(Entries[EntryIndex].Location, GridCellSize)))
+	{
+		CellEntries->RemoveSingleSwap(EntryIndex);
+	}
+}
+
+uint8 UExperiencePlayerStartSubsystem::GetTeamIdForPlayerStart(const APlayerStart* PlayerStart) const
+{
+	// Project-specific player starts can carry their own team
+	if (const IGenericTeamAgentInterface* TeamAgent = Cast<const IGenericTeamAgentInterface>(PlayerStart))
+	{
+		return TeamAgent->GetGenericTeamId().GetId();
+	}
+
+	for (const TPair<uint8, FName>& Pair : Settings.TeamPlayerStartTags)
+	{
+		if (Pair.Value == PlayerStart->PlayerStartTag)
+		{
+			return Pair.Key;
+		}
+	}
+
+	return NoTeamId;
+}
+
+int32 UExperiencePlayerStartSubsystem::FindOrAddBucket(uint8 TeamId)
+{
+	if (const int32* Existing = BucketLookup.Find(TeamId))
+	{
+		return *Existing;
+	}
+
+	const int32 BucketIndex = Buckets.AddDefaulted();
+	Buckets[BucketIndex].TeamId = TeamId;
+	BucketLookup.Add(TeamId, BucketIndex);
+	return BucketIndex;
+}
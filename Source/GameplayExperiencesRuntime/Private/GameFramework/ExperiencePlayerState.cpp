@@ -69,6 +69,64 @@ void AExperiencePlayerState::SetPawnData(const UExperiencePawnData* InPawnData)
 	ForceNetUpdate();
 }
 
+void AExperiencePlayerState::ClearPawnData()
+{
+	if (GetLocalRole() != ROLE_Authority || PawnData == nullptr)
+	{
+		return;
+	}
+
+	MARK_PROPERTY_DIRTY_FROM_NAME(ThisClass, PawnData, this);
+	const UExperiencePawnData* OldPawnData = PawnData;
+	PawnData = nullptr;
+
+	OnPawnDataChanged(OldPawnData, PawnData);
+
+	ForceNetUpdate();
+}
+
+void AExperiencePlayerState::BeginAbilitySystemHandoff(const APawn* FromPawn, const UExperiencePawnData* FromPawnData)
+{
+	HandoffPawn = FromPawn;
+	HandoffPawnData = FromPawnData;
+	bAbilitySystemHandoffPending = true;
+}
+
+bool AExperiencePlayerState::IsAbilitySystemHandoffPendingFrom(const AActor* FromAvatar) const
+{
+	// A pawn that has been destroyed in the meantime matches an avatar that has been cleared by garbage collection
+	return bAbilitySystemHandoffPending && HandoffPawn.Get() == FromAvatar;
+}
+
+bool AExperiencePlayerState::ConsumeAbilitySystemHandoff(const AActor* FromAvatar, const UExperiencePawnData*& OutFromPawnData)
+{
+	if (!IsAbilitySystemHandoffPendingFrom(FromAvatar))
+	{
+		return false;
+	}
+
+	OutFromPawnData = HandoffPawnData.Get();
+
+	HandoffPawn.Reset();
+	HandoffPawnData.Reset();
+	bAbilitySystemHandoffPending = false;
+	return true;
+}
+
+void AExperiencePlayerState::ResetPawnData()
+{
+	ClearPawnData();
+
+	if (GetLocalRole() == ROLE_Authority)
+	{
+		const UExperienceManagerComponent* ExperienceMgr = UExperienceManagerComponent::Get(this);
+		if (ExperienceMgr && ExperienceMgr->IsExperienceLoaded())
+		{
+			OnExperienceLoaded(ExperienceMgr->GetLoadedExperience_Checked());
+		}
+	}
+}
+
 void AExperiencePlayerState::OnExperienceLoaded(const UExperienceDefinition* CurrentExperience)
 {
 	if (const AModularExperienceGameModeBase* GameMode = GetWorld()->GetAuthGameMode<AModularExperienceGameModeBase>())
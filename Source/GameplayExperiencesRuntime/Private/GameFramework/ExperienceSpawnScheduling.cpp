@@ -0,0 +1,78 @@
+// Copyright © 2024 Playton. All Rights Reserved.
+
+
+#include "GameFramework/ExperienceSpawnScheduling.h"
+
+//////////////////////////////////////////////////////////////////////////
+/// FExperienceAdmissionBudget
+
+bool FExperienceAdmissionBudget::TryConsume(int32 MaxPerFrame, uint64 Frame)
+{
+	if (MaxPerFrame <= 0)
+	{
+		return true;
+	}
+
+	if (LastFrame != Frame)
+	{
+		LastFrame = Frame;
+		NumConsumed = 0;
+	}
+
+	if (NumConsumed >= MaxPerFrame)
+	{
+		return false;
+	}
+
+	++NumConsumed;
+	return true;
+}
+
+//////////////////////////////////////////////////////////////////////////
+/// FExperienceRestartRetryQueue
+
+void FExperienceRestartRetryQueue::Schedule(TObjectKey<AController> Controller, double AttemptTime, uint64 Frame)
+{
+	FAttempt Attempt;
+	Attempt.AttemptTime = AttemptTime;
+	Attempt.ScheduledFrame = Frame;
+	Attempt.Controller = Controller;
+
+	Heap.HeapPush(Attempt);
+}
+
+bool FExperienceRestartRetryQueue::PopDue(double Now, uint64 Frame, FAttempt& OutAttempt)
+{
+	while (Heap.Num() > 0 && Heap.HeapTop().AttemptTime <= Now)
+	{
+		FAttempt Attempt;
+		Heap.HeapPop(Attempt, EAllowShrinking::No);
+
+		if (Attempt.ScheduledFrame == Frame)
+		{
+			HeldBack.Add(Attempt);
+			continue;
+		}
+
+		OutAttempt = Attempt;
+		return true;
+	}
+
+	return false;
+}
+
+void FExperienceRestartRetryQueue::EndPass()
+{
+	for (const FAttempt& Attempt : HeldBack)
+	{
+		Heap.HeapPush(Attempt);
+	}
+
+	HeldBack.Reset();
+}
+
+void FExperienceRestartRetryQueue::Reset()
+{
+	Heap.Reset();
+	HeldBack.Reset();
+}
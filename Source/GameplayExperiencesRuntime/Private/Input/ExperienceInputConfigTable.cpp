@@ -0,0 +1,144 @@
+// Copyright © 2024 Playton. All Rights Reserved.
+
+
+#include "Input/ExperienceInputConfigTable.h"
+
+#include "ExperiencePawnData.h"
+#include "GameplayExperiencesLog.h"
+#include "Algo/StableSort.h"
+#include "Actions/GameFeatureAction_AddInputConfig.h"
+
+namespace ExperienceInputConfigTable
+{
+	struct FSource
+	{
+		const UInputConfig* InputConfig = nullptr;
+		int32 Priority = 0;
+	};
+
+	/** Adds the bindings of the sources in order, keeping the first binding of each tag and reporting the ones it overrides. */
+	static void MergeBindings(const UExperiencePawnData* PawnData, TConstArrayView<FSource> Sources,
+		TArray<FInputConfig_ActionBinding> UInputConfig::* Bindings, TArray<FInputConfig_ActionBinding>& OutBindings)
+	{
+		// Index of the source and of the merged binding of each tag
+		TMap<FGameplayTag, TPair<int32, int32>> WinningBindings;
+
+		for (int32 SourceIndex = 0; SourceIndex < Sources.Num(); ++SourceIndex)
+		{
+			const FSource& Source = Sources[SourceIndex];
+			for (const FInputConfig_ActionBinding& Binding : Source.InputConfig->*Bindings)
+			{
+				if (Binding.InputAction == nullptr || !Binding.GameplayTag.IsValid())
+				{
+					continue;
+				}
+
+				const TPair<int32, int32>* WinningBinding = WinningBindings.Find(Binding.GameplayTag);
+				if (WinningBinding == nullptr)
+				{
+					WinningBindings.Add(Binding.GameplayTag, { SourceIndex, OutBindings.Add(Binding) });
+					continue;
+				}
+
+				const FSource& WinningSource = Sources[WinningBinding->Key];
+				const UInputAction* WinningInputAction = OutBindings[WinningBinding->Value].InputAction;
+				if (WinningInputAction == Binding.InputAction)
+				{
+					continue;
+				}
+
+				// Overriding a lower priority config is what priorities are for, configs of the same priority are ambiguous
+				if (WinningSource.Priority == Source.Priority && WinningSource.InputConfig != Source.InputConfig)
+				{
+					EXPERIENCE_LOG(Warning, TEXT("Input tag '%s' of pawn data '%s' is bound to '%s' by '%s' and to '%s' by '%s', both with priority %d. Keeping '%s'."),
+						*Binding.GameplayTag.ToString(), *GetNameSafe(PawnData),
+						*GetNameSafe(WinningInputAction), *GetNameSafe(WinningSource.InputConfig),
+						*GetNameSafe(Binding.InputAction), *GetNameSafe(Source.InputConfig),
+						Source.Priority, *GetNameSafe(WinningInputAction));
+				}
+				else
+				{
+					EXPERIENCE_LOG(Log, TEXT("Input tag '%s' of pawn data '%s' is bound to '%s' by '%s' (priority %d), overriding '%s' of '%s' (priority %d)."),
+						*Binding.GameplayTag.ToString(), *GetNameSafe(PawnData),
+						*GetNameSafe(WinningInputAction), *GetNameSafe(WinningSource.InputConfig), WinningSource.Priority,
+						*GetNameSafe(Binding.InputAction), *GetNameSafe(Source.InputConfig), Source.Priority);
+				}
+			}
+		}
+	}
+}
+
+TSharedRef<const FExperienceInputConfigTable> FExperienceInputConfigTable::Build(const UExperiencePawnData* PawnData, TConstArrayView<FExperienceInputConfigEntry> Contributions)
+{
+	using namespace ExperienceInputConfigTable;
+
+	TSharedRef<FExperienceInputConfigTable> Table = MakeShared<FExperienceInputConfigTable>();
+	Table->BaseInputConfig = PawnData ? PawnData->InputConfig.Get() : nullptr;
+
+	// The config of the pawn data goes first, so it wins over contributions of the same priority
+	TArray<FSource, TInlineAllocator<8>> Sources;
+	if (Table->BaseInputConfig)
+	{
+		Sources.Add({ Table->BaseInputConfig, 0 });
+	}
+
+	const FSoftObjectPath PawnDataPath(PawnData);
+	for (const FExperienceInputConfigEntry& Contribution : Contributions)
+	{
+		const bool bAppliesToPawnData = Contribution.PawnData.IsEmpty() || Contribution.PawnData.ContainsByPredicate([&PawnDataPath](const TSoftObjectPtr<const UExperiencePawnData>& Filter)
+		{
+			return Filter.ToSoftObjectPath() == PawnDataPath;
+		});
+
+		if (Contribution.InputConfig.IsNull() || !bAppliesToPawnData)
+		{
+			continue;
+		}
+
+		// Streamed with the client bundle of the experience
+		const UInputConfig* InputConfig = Contribution.InputConfig.Get();
+		if (InputConfig == nullptr)
+		{
+			EXPERIENCE_LOG(Warning, TEXT("Input config '%s' wasn't loaded with the experience"), *Contribution.InputConfig.ToString());
+			InputConfig = Contribution.InputConfig.LoadSynchronous();
+		}
+
+		if (InputConfig)
+		{
+			Sources.Add({ InputConfig, Contribution.Priority });
+		}
+	}
+
+	Algo::StableSortBy(Sources, [](const FSource& Source) { return Source.Priority; }, TGreater<>());
+
+	for (const FSource& Source : Sources)
+	{
+		Table->SourceConfigs.Emplace(Source.InputConfig);
+	}
+
+	MergeBindings(PawnData, Sources, &UInputConfig::NativeInputActions, Table->NativeInputActions);
+	MergeBindings(PawnData, Sources, &UInputConfig::AbilityInputActions, Table->AbilityInputActions);
+
+	Table->Lookup.AddBindings(Table->NativeInputActions, Table->AbilityInputActions);
+
+	for (const FSource& Source : Sources)
+	{
+		for (const FInputMappingContextAndPriority& Mapping : Source.InputConfig->InputMappings)
+		{
+			const bool bAlreadyMapped = Table->InputMappings.ContainsByPredicate([&Mapping](const FInputMappingContextAndPriority& Other)
+			{
+				return Other.InputMapping == Mapping.InputMapping;
+			});
+
+			if (!bAlreadyMapped)
+			{
+				Table->InputMappings.Add(Mapping);
+			}
+		}
+	}
+
+	EXPERIENCE_LOG(Verbose, TEXT("Built input config table of pawn data '%s' from %d configs: %d native and %d ability bindings, %d input mappings"),
+		*GetNameSafe(PawnData), Sources.Num(), Table->NativeInputActions.Num(), Table->AbilityInputActions.Num(), Table->InputMappings.Num());
+
+	return Table;
+}
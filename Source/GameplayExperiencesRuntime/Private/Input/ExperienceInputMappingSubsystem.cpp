@@ -0,0 +1,72 @@
+// Copyright © 2024 Playton. All Rights Reserved.
+
+
+#include "Input/ExperienceInputMappingSubsystem.h"
+
+#include "EnhancedInputSubsystems.h"
+#include "GameplayExperiencesLog.h"
+#include "InputMappingContext.h"
+#include "Engine/LocalPlayer.h"
+#include "UserSettings/EnhancedInputUserSettings.h"
+
+#include UE_INLINE_GENERATED_CPP_BY_NAME(ExperienceInputMappingSubsystem)
+
+int32 UExperienceInputMappingSubsystem::ApplyInputMappings(TConstArrayView<FInputMappingContextAndPriority> Mappings)
+{
+	UEnhancedInputLocalPlayerSubsystem* InputSub = GetLocalPlayerChecked()->GetSubsystem<UEnhancedInputLocalPlayerSubsystem>();
+	check(InputSub);
+
+	UEnhancedInputUserSettings* Settings = InputSub->GetUserSettings();
+
+	TMap<TObjectPtr<UInputMappingContext>, int32> DesiredMappings;
+	DesiredMappings.Reserve(Mappings.Num());
+
+	for (const FInputMappingContextAndPriority& Mapping : Mappings)
+	{
+		UInputMappingContext* IMC = Mapping.InputMapping.Get();
+		if (IMC == nullptr)
+		{
+			continue;
+		}
+
+		DesiredMappings.Add(IMC, Mapping.Priority);
+
+		if (Mapping.bRegisterWithSettings && Settings && !Settings->IsMappingContextRegistered(IMC))
+		{
+			Settings->RegisterInputMappingContext(IMC);
+		}
+	}
+
+	// Deferred, so every change below ends up in a single rebuild of the control mappings
+	FModifyContextOptions Options = {};
+	Options.bIgnoreAllPressedKeysUntilRelease = false;
+	Options.bForceImmediately = false;
+
+	int32 NumChanges = 0;
+
+	for (const TPair<TObjectPtr<UInputMappingContext>, int32>& Applied : AppliedMappings)
+	{
+		if (Applied.Key && !DesiredMappings.Contains(Applied.Key))
+		{
+			InputSub->RemoveMappingContext(Applied.Key, Options);
+			++NumChanges;
+		}
+	}
+
+	for (const TPair<TObjectPtr<UInputMappingContext>, int32>& Desired : DesiredMappings)
+	{
+		const int32* AppliedPriority = AppliedMappings.Find(Desired.Key);
+		if (AppliedPriority == nullptr || *AppliedPriority != Desired.Value || !InputSub->HasMappingContext(Desired.Key))
+		{
+			InputSub->AddMappingContext(Desired.Key, Desired.Value, Options);
+			++NumChanges;
+		}
+	}
+
+	AppliedMappings = MoveTemp(DesiredMappings);
+
+	EXPERIENCE_LOG(Verbose, TEXT("Applied %d input mapping contexts for [%s], %d changed"),
+		AppliedMappings.Num(), *GetNameSafe(GetLocalPlayer()), NumChanges);
+
+	return NumChanges;
+}
@@ -4,6 +4,7 @@
 #include "Input/InputConfig.h"
 
 #include "GameplayExperiencesLog.h"
+#include "HAL/IConsoleManager.h"
 
 #include UE_INLINE_GENERATED_CPP_BY_NAME(InputConfig)
 
@@ -20,39 +21,233 @@ UInputConfig::UInputConfig(const FObjectInitializer& ObjectInitializer)
 
 const UInputAction* UInputConfig::FindNativeInputActionByTag(const FGameplayTag& Tag, bool bLogNotFound) const
 {
-	return FindInputAction(Tag, NativeInputActions, bLogNotFound);
+	const UInputAction* InputAction = GetLookup().FindNativeInputAction(Tag);
+	if (InputAction == nullptr && bLogNotFound)
+	{
+		LogInputActionNotFound(Tag);
+	}
+
+	return InputAction;
 }
 
 const UInputAction* UInputConfig::FindAbilityInputActionByTag(const FGameplayTag& Tag, bool bLogNotFound) const
 {
-	return FindInputAction(Tag, AbilityInputActions, bLogNotFound);
+	const UInputAction* InputAction = GetLookup().FindAbilityInputAction(Tag);
+	if (InputAction == nullptr && bLogNotFound)
+	{
+		LogInputActionNotFound(Tag);
+	}
+
+	return InputAction;
+}
+
+FGameplayTag UInputConfig::FindTagForInputAction(const UInputAction* InputAction) const
+{
+	return GetLookup().FindTagForInputAction(InputAction);
 }
 
-const UInputAction* UInputConfig::FindInputAction(const FGameplayTag& Tag, const TArray<FInputConfig_ActionBinding>& InputActions, bool bLogNotFound) const
+void UInputConfig::FindNativeInputActionsByTags(TConstArrayView<FGameplayTag> Tags, TArray<const UInputAction*>& OutInputActions) const
 {
-	for (const auto& Action : InputActions)
+	const FInputConfigLookup& CompiledLookup = GetLookup();
+
+	OutInputActions.Reset(Tags.Num());
+	for (const FGameplayTag& Tag : Tags)
 	{
-		if (Action.InputAction == nullptr)
-		{
-			continue;
-		}
+		OutInputActions.Add(CompiledLookup.FindNativeInputAction(Tag));
+	}
+}
+
+void UInputConfig::FindAbilityInputActionsByTags(TConstArrayView<FGameplayTag> Tags, TArray<const UInputAction*>& OutInputActions) const
+{
+	const FInputConfigLookup& CompiledLookup = GetLookup();
+
+	OutInputActions.Reset(Tags.Num());
+	for (const FGameplayTag& Tag : Tags)
+	{
+		OutInputActions.Add(CompiledLookup.FindAbilityInputAction(Tag));
+	}
+}
+
+const FInputConfigLookup& UInputConfig::GetLookup() const
+{
+	if (!bLookupCompiled)
+	{
+		CompileLookup();
+	}
+
+	return Lookup;
+}
+
+void UInputConfig::PostLoad()
+{
+	Super::PostLoad();
+
+	CompileLookup();
+}
+
+#if WITH_EDITOR
+void UInputConfig::PostEditChangeProperty(FPropertyChangedEvent& PropertyChangedEvent)
+{
+	Super::PostEditChangeProperty(PropertyChangedEvent);
+
+	bLookupCompiled = false;
+}
+
+void UInputConfig::PostEditUndo()
+{
+	Super::PostEditUndo();
+
+	bLookupCompiled = false;
+}
+#endif
+
+void UInputConfig::CompileLookup() const
+{
+	Lookup.Reset();
+	Lookup.AddBindings(NativeInputActions, AbilityInputActions);
+	bLookupCompiled = true;
+}
+
+void UInputConfig::LogInputActionNotFound(const FGameplayTag& Tag) const
+{
+	EXPERIENCE_LOG(Warning, TEXT("Failed to find input action for tag '%s' on InputConfig '%s'"), *Tag.ToString(), *GetNameSafe(this));
+}
+
+//////////////////////////////////////////////////////////////////////////
+/// FInputConfigLookup
+
+void FInputConfigLookup::Reset()
+{
+	NativeInputActions.Reset();
+	AbilityInputActions.Reset();
+	InputActionTags.Reset();
+}
 
-		if (!Action.GameplayTag.MatchesTagExact(Tag))
+void FInputConfigLookup::AddBindings(TConstArrayView<FInputConfig_ActionBinding> NativeBindings, TConstArrayView<FInputConfig_ActionBinding> AbilityBindings)
+{
+	// The first binding of a tag wins, same as the linear search used to
+	auto AddBindingsTo = [this](TConstArrayView<FInputConfig_ActionBinding> Bindings, TMap<FGameplayTag, const UInputAction*>& InputActions)
+	{
+		for (const FInputConfig_ActionBinding& Binding : Bindings)
 		{
-			continue;
+			if (Binding.InputAction == nullptr || !Binding.GameplayTag.IsValid())
+			{
+				continue;
+			}
+
+			if (!InputActions.Contains(Binding.GameplayTag))
+			{
+				InputActions.Add(Binding.GameplayTag, Binding.InputAction);
+			}
+
+			if (!InputActionTags.Contains(Binding.InputAction))
+			{
+				InputActionTags.Add(Binding.InputAction, Binding.GameplayTag);
+			}
 		}
+	};
 
-		return Action.InputAction;
-	}
+	AddBindingsTo(NativeBindings, NativeInputActions);
+	AddBindingsTo(AbilityBindings, AbilityInputActions);
+}
 
-	if (bLogNotFound)
+//////////////////////////////////////////////////////////////////////////
+/// FInputConfigBenchmark
+
+#if !UE_BUILD_SHIPPING
+const UInputAction* UInputConfig::FindInputActionLinear(const FGameplayTag& Tag, const TArray<FInputConfig_ActionBinding>& InputActions)
+{
+	for (const FInputConfig_ActionBinding& Action : InputActions)
 	{
-		EXPERIENCE_LOG(Warning, TEXT("Failed to find input action for tag '%s' on InputConfig '%s'"), *Tag.ToString(), *GetNameSafe(this));
+		if (Action.InputAction != nullptr && Action.GameplayTag.MatchesTagExact(Tag))
+		{
+			return Action.InputAction;
+		}
 	}
 
 	return nullptr;
 }
 
+/** Compares the compiled lookups of an input config against a linear search over its bindings. */
+struct FInputConfigBenchmark
+{
+	static void Run(const TArray<FString>& Args)
+	{
+		if (Args.Num() < 1)
+		{
+			EXPERIENCE_LOG(Display, TEXT("Usage: Experience.Input.BenchmarkInputConfig <InputConfigPath> [Iterations]"));
+			return;
+		}
+
+		const UInputConfig* InputConfig = LoadObject<UInputConfig>(nullptr, *Args[0]);
+		if (InputConfig == nullptr)
+		{
+			EXPERIENCE_LOG(Error, TEXT("Failed to load input config '%s'"), *Args[0]);
+			return;
+		}
+
+		const int32 Iterations = Args.Num() > 1 ? FMath::Max(1, FCString::Atoi(*Args[1])) : 100000;
+
+		TArray<FGameplayTag> Tags;
+		TArray<const UInputAction*> Actions;
+		for (const FInputConfig_ActionBinding& Binding : InputConfig->AbilityInputActions)
+		{
+			Tags.Add(Binding.GameplayTag);
+			Actions.Add(Binding.InputAction);
+		}
+
+		if (Tags.Num() == 0)
+		{
+			EXPERIENCE_LOG(Display, TEXT("Input config '%s' has no ability input actions to look up"), *GetNameSafe(InputConfig));
+			return;
+		}
+
+		// Accumulate the results so the lookups can't be optimized away
+		uintptr_t Sink = 0;
+
+		const double LinearStart = FPlatformTime::Seconds();
+		for (int32 Iteration = 0; Iteration < Iterations; ++Iteration)
+		{
+			for (const FGameplayTag& Tag : Tags)
+			{
+				Sink += reinterpret_cast<uintptr_t>(UInputConfig::FindInputActionLinear(Tag, InputConfig->AbilityInputActions));
+			}
+		}
+		const double LinearTime = FPlatformTime::Seconds() - LinearStart;
+
+		const double CompiledStart = FPlatformTime::Seconds();
+		for (int32 Iteration = 0; Iteration < Iterations; ++Iteration)
+		{
+			for (const FGameplayTag& Tag : Tags)
+			{
+				Sink += reinterpret_cast<uintptr_t>(InputConfig->FindAbilityInputActionByTag(Tag, false));
+			}
+		}
+		const double CompiledTime = FPlatformTime::Seconds() - CompiledStart;
+
+		const double ReverseStart = FPlatformTime::Seconds();
+		for (int32 Iteration = 0; Iteration < Iterations; ++Iteration)
+		{
+			for (const UInputAction* Action : Actions)
+			{
+				Sink += InputConfig->FindTagForInputAction(Action).IsValid() ? 1 : 0;
+			}
+		}
+		const double ReverseTime = FPlatformTime::Seconds() - ReverseStart;
+
+		const double NumLookups = static_cast<double>(Iterations) * Tags.Num();
+		EXPERIENCE_LOG(Display, TEXT("Input config '%s', %d bindings, %.0f lookups: linear %.1f ns, compiled %.1f ns, reverse %.1f ns per lookup (%llu)"),
+			*GetNameSafe(InputConfig), Tags.Num(), NumLookups,
+			LinearTime * 1e9 / NumLookups, CompiledTime * 1e9 / NumLookups, ReverseTime * 1e9 / NumLookups, static_cast<uint64>(Sink & 1));
+	}
+};
+
+static FAutoConsoleCommand BenchmarkInputConfigCommand(
+	TEXT("Experience.Input.BenchmarkInputConfig"),
+	TEXT("Times tag lookups on an input config, linear search against the compiled lookups. Usage: Experience.Input.BenchmarkInputConfig <InputConfigPath> [Iterations]"),
+	FConsoleCommandWithArgsDelegate::CreateStatic(&FInputConfigBenchmark::Run));
+#endif
+
 #if WITH_EDITOR
 
 EDataValidationResult UInputConfig::IsDataValid(class FDataValidationContext& Context) const
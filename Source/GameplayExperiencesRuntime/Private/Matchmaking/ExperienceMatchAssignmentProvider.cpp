@@ -0,0 +1,116 @@
+// Copyright © 2024 Playton. All Rights Reserved.
+
+
+#include "Matchmaking/ExperienceMatchAssignmentProvider.h"
+
+#include "ExperienceDefinition.h"
+#include "GameplayExperiencesLog.h"
+#include "HAL/FileManager.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+
+#include UE_INLINE_GENERATED_CPP_BY_NAME(ExperienceMatchAssignmentProvider)
+
+//////////////////////////////////////////////////////////////////////////
+/// UExperienceMatchAssignmentProvider
+
+UExperienceMatchAssignmentProvider::UExperienceMatchAssignmentProvider()
+{
+}
+
+void UExperienceMatchAssignmentProvider::ReceiveAssignment(const FExperienceMatchAssignment& Assignment)
+{
+	EXPERIENCE_LOG(Log, TEXT("Received match assignment '%s' (experience '%s') from %s"),
+		*Assignment.MatchId, *Assignment.ExperienceId.ToString(), *GetNameSafe(GetClass()));
+
+	OnAssignmentReceived.Broadcast(Assignment);
+}
+
+//////////////////////////////////////////////////////////////////////////
+/// UExperienceFileMatchAssignmentProvider
+
+UExperienceFileMatchAssignmentProvider::UExperienceFileMatchAssignmentProvider()
+{
+	AssignmentFilePath = TEXT("MatchAssignment.ini");
+}
+
+void UExperienceFileMatchAssignmentProvider::StartListening()
+{
+	FString FilePath = AssignmentFilePath;
+	FParse::Value(FCommandLine::Get(), TEXT("MatchAssignmentFile="), FilePath);
+
+	ResolvedFilePath = FPaths::IsRelative(FilePath) ? FPaths::Combine(FPaths::ProjectSavedDir(), FilePath) : FilePath;
+	EXPERIENCE_LOG(Log, TEXT("Waiting for match assignment file '%s'"), *ResolvedFilePath);
+
+	// Check right away, the file may have been written before the server started
+	PollAssignmentFile(0.f);
+	PollHandle = FTSTicker::GetCoreTicker().AddTicker(FTickerDelegate::CreateUObject(this, &ThisClass::PollAssignmentFile), PollInterval);
+}
+
+void UExperienceFileMatchAssignmentProvider::StopListening()
+{
+	FTSTicker::GetCoreTicker().RemoveTicker(PollHandle);
+	PollHandle.Reset();
+}
+
+bool UExperienceFileMatchAssignmentProvider::PollAssignmentFile(float DeltaTime)
+{
+	// Only a rewritten file is a new assignment
+	const FDateTime TimeStamp = IFileManager::Get().GetTimeStamp(*ResolvedFilePath);
+	if (TimeStamp == FDateTime::MinValue() || TimeStamp == LastAssignmentTimeStamp)
+	{
+		return true;
+	}
+
+	FString Contents;
+	FExperienceMatchAssignment Assignment;
+	if (!FFileHelper::LoadFileToString(Contents, *ResolvedFilePath) || !ParseAssignment(Contents, Assignment))
+	{
+		// Might still be in the middle of being written, try again later
+		EXPERIENCE_LOG(Verbose, TEXT("Match assignment file '%s' could not be parsed yet"), *ResolvedFilePath);
+		return true;
+	}
+
+	LastAssignmentTimeStamp = TimeStamp;
+	ReceiveAssignment(Assignment);
+
+	// Keep ticking, the next match of this server gets assigned through the same file
+	return true;
+}
+
+bool UExperienceFileMatchAssignmentProvider::ParseAssignment(const FString& Contents, FExperienceMatchAssignment& OutAssignment) const
+{
+	TArray<FString> Lines;
+	Contents.ParseIntoArrayLines(Lines);
+
+	for (const FString& Line : Lines)
+	{
+		FString Key, Value;
+		if (!Line.Split(TEXT("="), &Key, &Value))
+		{
+			continue;
+		}
+
+		Key.TrimStartAndEndInline();
+		Value.TrimStartAndEndInline();
+
+		if (Key == TEXT("Experience"))
+		{
+			OutAssignment.ExperienceId = FPrimaryAssetId::ParseTypeAndName(Value);
+			if (!OutAssignment.ExperienceId.PrimaryAssetType.IsValid())
+			{
+				OutAssignment.ExperienceId = FPrimaryAssetId(FPrimaryAssetType(UExperienceDefinition::StaticClass()->GetFName()), FName(*Value));
+			}
+		}
+		else if (Key == TEXT("MatchId"))
+		{
+			OutAssignment.MatchId = Value;
+		}
+		else if (Key == TEXT("Options"))
+		{
+			OutAssignment.Options = Value;
+		}
+	}
+
+	return OutAssignment.ExperienceId.IsValid();
+}
@@ -13,19 +13,34 @@
 #define LOCTEXT_NAMESPACE "ModularExperienceGameMode"
 #endif
 
+#include "AIController.h"
 #include "ExperienceAssetManager.h"
+#include "ExperienceManagerSubsystem.h"
 #include "ExperiencePawnData.h"
 #include "ExperienceWorldSettings.h"
 #include "GameFeaturesSubsystem.h"
 #include "GameplayExperiencesLog.h"
+#include "GameplayExperiencesStats.h"
+#include "GenericTeamAgentInterface.h"
 #include "ModularExperienceGameState.h"
 #include "Components/ExperiencePawnExtensionComponent.h"
 #include "Developer/ExperienceGameSettings.h"
 #include "Engine/AssetManager.h"
+#include "GameFramework/ExperiencePlayerStartSubsystem.h"
+#include "GameFramework/GameSession.h"
+#include "GameFramework/PlayerStart.h"
 #include "Kismet/GameplayStatics.h"
 
 #include UE_INLINE_GENERATED_CPP_BY_NAME(ModularExperienceGameMode)
 
+DECLARE_CYCLE_STAT(TEXT("Process Admission Queue"), STAT_ExperienceProcessAdmissionQueue, STATGROUP_GameplayExperiences);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Admission Queue Length"), STAT_ExperienceAdmissionQueueLength, STATGROUP_GameplayExperiences);
+DECLARE_FLOAT_ACCUMULATOR_STAT(TEXT("Last Time To Pawn (s)"), STAT_ExperienceLastTimeToPawn, STATGROUP_GameplayExperiences);
+DECLARE_CYCLE_STAT(TEXT("Process Bot Fill"), STAT_ExperienceProcessBotFill, STATGROUP_GameplayExperiences);
+DECLARE_CYCLE_STAT(TEXT("Process Restart Retries"), STAT_ExperienceProcessRestartRetries, STATGROUP_GameplayExperiences);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Restart Retries"), STAT_ExperienceRestartRetries, STATGROUP_GameplayExperiences);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Failed Restarts"), STAT_ExperienceFailedRestarts, STATGROUP_GameplayExperiences);
+
 //////////////////////////////////////////////////////////////////////////
 /// AModularExperienceGameMode
 
@@ -34,6 +49,10 @@ AModularExperienceGameModeBase::AModularExperienceGameModeBase(const FObjectInit
 {
 	PlayerStateClass = AExperiencePlayerState::StaticClass();
 	GameStateClass = AModularExperienceGameState::StaticClass();
+
+	// Only ticks while there is work pending, e.g. players waiting to be admitted
+	PrimaryActorTick.bCanEverTick = true;
+	PrimaryActorTick.bStartWithTickEnabled = false;
 }
 
 const UExperiencePawnData* AModularExperienceGameModeBase::GetPawnDataForController(const AController* InController) const
@@ -58,9 +77,20 @@ const UExperiencePawnData* AModularExperienceGameModeBase::GetPawnDataForControl
 	if (ExperienceMgr->IsExperienceLoaded())
 	{
 		const UExperienceDefinition* ExperienceDefinition = ExperienceMgr->GetLoadedExperience_Checked();
-		if (ExperienceDefinition->DefaultPawnData != nullptr)
+
+		// Bots share the bot pawn data, picked up right away when their player state is created
+		if (InController != nullptr && !InController->IsPlayerController() && !ExperienceDefinition->BotFillSettings.BotPawnData.IsNull())
+		{
+			if (const UExperiencePawnData* BotPawnData = UExperienceAssetManager::GetAsset(ExperienceDefinition->BotFillSettings.BotPawnData))
+			{
+				return BotPawnData;
+			}
+		}
+
+		// Streamed with the bundles of the experience, only loaded here if they didn't cover it
+		if (const UExperiencePawnData* PawnData = UExperienceAssetManager::GetAsset(ExperienceDefinition->DefaultPawnData))
 		{
-			return ExperienceDefinition->DefaultPawnData;
+			return PawnData;
 		}
 
 		// If none found, fall back to the default pawn data
@@ -99,17 +129,25 @@ void AModularExperienceGameModeBase::HandleMatchAssignmentIfNotExpectingOne()
 	FString ExperienceIdSource;
 
 	// Precedence order (highest wins)
-	//  – Matchmaking assignment (if present)
+	//  – Matchmaking assignment (if already received)
 	//  – URL Options override
+	//  – Matchmaking assignment (dedicated server waits for one)
 	//  – Developer Settings (PIE only)
 	//  – Command Line override
 	//  – World Settings
-	//  – Dedicated server
 	//  – Default experience
 
 	UWorld* World = GetWorld();
 
 	// Matchmaking assignment
+	FExperienceMatchAssignment MatchAssignment;
+	if (UExperienceManagerSubsystem::Get()->ClaimMatchAssignment(World, MatchAssignment) && MatchAssignment.ExperienceId.IsValid())
+	{
+		ApplyMatchAssignmentOptions(MatchAssignment.Options);
+
+		ExperienceId = MatchAssignment.ExperienceId;
+		ExperienceIdSource = TEXT("Matchmaking Assignment");
+	}
 
 	// URL Options override
 	if (!ExperienceId.IsValid() && UGameplayStatics::HasOption(OptionsString, TEXT("Experience")))
@@ -119,6 +157,13 @@ void AModularExperienceGameModeBase::HandleMatchAssignmentIfNotExpectingOne()
 		ExperienceIdSource = TEXT("URL Options");
 	}
 
+	// An explicit experience doesn't have to wait for matchmaking
+	if (!ExperienceId.IsValid() && TryDedicatedServerLogin())
+	{
+		// Waiting for the assignment, OnMatchAssignmentReceived takes it from here
+		return;
+	}
+
 	// Developer Settings (PIE only)
 	if (!ExperienceId.IsValid() && World->IsPlayInEditor())
 	{
@@ -170,11 +215,6 @@ void AModularExperienceGameModeBase::HandleMatchAssignmentIfNotExpectingOne()
 	// Default experience
 	if (!ExperienceId.IsValid())
 	{
-		if (TryDedicatedServerLogin())
-		{
-			return;
-		}
-
 		// See if we override the default experience
 		if (DefaultExperienceOverride.IsValid())
 		{
@@ -210,6 +250,8 @@ void AModularExperienceGameModeBase::HandleMatchAssignmentIfNotExpectingOne()
 
 void AModularExperienceGameModeBase::OnMatchAssignmentGiven(FPrimaryAssetId ExperienceId, const FString& ExperienceIdSource)
 {
+	bMatchAssignmentGiven = true;
+
 	if (ExperienceId.IsValid())
 	{
 		EXPERIENCE_LOG(Log, TEXT("Identified experience '%s' from %s"), *ExperienceId.ToString(), *ExperienceIdSource);
@@ -227,20 +269,122 @@ void AModularExperienceGameModeBase::OnMatchAssignmentGiven(FPrimaryAssetId Expe
 
 void AModularExperienceGameModeBase::OnExperienceLoaded(const UExperienceDefinition* CurrentExperience)
 {
-	// Spawn any actors that need to be spawned
+	// Index the player starts before anyone gets spawned
+	if (UExperiencePlayerStartSubsystem* PlayerStartSubsystem = GetWorld()->GetSubsystem<UExperiencePlayerStartSubsystem>())
+	{
+		if (CurrentExperience->PlayerStartSettings.bUseIndexedPlayerStarts)
+		{
+			PlayerStartSubsystem->BuildIndex(CurrentExperience->PlayerStartSettings);
+		}
+	}
+
+	// Queue up any players that still need to be spawned, players that started during the load are already waiting in arrival order
 	for (auto It = GetWorld()->GetPlayerControllerIterator(); It; ++It)
 	{
 		APlayerController* PC = Cast<APlayerController>(*It);
 		if (PC && PC->GetPawn() == nullptr)
 		{
-			if (PlayerCanRestart(PC))
-			{
-				RestartPlayer(PC);
-			}
+			EnqueueAdmission(PC);
+		}
+	}
+
+	ProcessAdmissionQueue();
+
+	if (HasPendingTickWork())
+	{
+		SetActorTickEnabled(true);
+	}
+
+	// Fill the match with bots, spread over the next frames
+	int32 NumBots = CurrentExperience->BotFillSettings.NumBots;
+	FParse::Value(FCommandLine::Get(), TEXT("NumBots="), NumBots);
+	if (NumBots > 0)
+	{
+		RequestBotFill(NumBots);
+	}
+}
+
+void AModularExperienceGameModeBase::RequestBotFill(int32 NumBots)
+{
+	NumBotsWanted = FMath::Max(0, NumBots);
+
+	EXPERIENCE_LOG(Log, TEXT("Filling the match with %d bots (%d per frame)."), NumBotsWanted, FMath::Max(MaxBotSpawnsPerFrame, 1));
+
+	ProcessBotFill();
+
+	if (HasPendingTickWork())
+	{
+		SetActorTickEnabled(true);
+	}
+}
+
+int32 AModularExperienceGameModeBase::GetNumBots() const
+{
+	int32 NumBots = 0;
+	for (const TWeakObjectPtr<AAIController>& Bot : SpawnedBots)
+	{
+		NumBots += Bot.IsValid() ? 1 : 0;
+	}
+
+	return NumBots;
+}
+
+void AModularExperienceGameModeBase::ProcessBotFill()
+{
+	SCOPE_CYCLE_COUNTER(STAT_ExperienceProcessBotFill);
+
+	if (SpawnedBots.Num() >= NumBotsWanted || !IsExperienceLoaded())
+	{
+		return;
+	}
+
+	SpawnedBots.RemoveAll([](const TWeakObjectPtr<AAIController>& Bot) { return !Bot.IsValid(); });
+
+	// Each bot spawns its pawn and initializes its ability system right away, so the spawn budget bounds that work as well
+	const int32 NumToSpawn = FMath::Min(NumBotsWanted - SpawnedBots.Num(), FMath::Max(MaxBotSpawnsPerFrame, 1));
+	for (int32 Idx = 0; Idx < NumToSpawn; ++Idx)
+	{
+		AAIController* Bot = SpawnBot(SpawnedBots.Num());
+		if (Bot == nullptr)
+		{
+			EXPERIENCE_LOG(Error, TEXT("Failed to spawn a bot, stopping the bot fill at %d bots."), SpawnedBots.Num());
+			NumBotsWanted = SpawnedBots.Num();
+			return;
 		}
+
+		SpawnedBots.Add(Bot);
 	}
 }
 
+AAIController* AModularExperienceGameModeBase::SpawnBot(int32 BotIndex)
+{
+	const FExperienceBotFillSettings& BotFillSettings = UExperienceManagerComponent::Get(GameState)->GetLoadedExperience_Checked()->BotFillSettings;
+	UClass* BotControllerClass = BotFillSettings.BotControllerClass ? BotFillSettings.BotControllerClass.Get() : AAIController::StaticClass();
+
+	FActorSpawnParameters SpawnInfo;
+	SpawnInfo.SpawnCollisionHandlingOverride = ESpawnActorCollisionHandlingMethod::AlwaysSpawn;
+	SpawnInfo.OverrideLevel = GetLevel();
+	SpawnInfo.ObjectFlags |= RF_Transient;
+	SpawnInfo.bDeferConstruction = true;
+
+	AAIController* Bot = GetWorld()->SpawnActor<AAIController>(BotControllerClass, SpawnInfo);
+	if (Bot == nullptr)
+	{
+		return nullptr;
+	}
+
+	// Bots need a player state to go through the same pawn data and ability system setup as players
+	// The player state picks up the bot pawn data as it is created, see GetPawnDataForController
+	Bot->bWantsPlayerState = true;
+	Bot->FinishSpawning(FTransform::Identity, true);
+
+	ChangeName(Bot, FString::Printf(TEXT("Bot %d"), BotIndex + 1), false);
+	GenericPlayerInitialization(Bot);
+	RestartPlayer(Bot);
+
+	return Bot;
+}
+
 bool AModularExperienceGameModeBase::IsExperienceLoaded() const
 {
 	check(GameState);
@@ -252,7 +396,43 @@ bool AModularExperienceGameModeBase::IsExperienceLoaded() const
 
 bool AModularExperienceGameModeBase::TryDedicatedServerLogin()
 {
-	return false;
+	UExperienceManagerSubsystem* ExperienceSubsystem = UExperienceManagerSubsystem::Get();
+	if (GetNetMode() != NM_DedicatedServer || !ExperienceSubsystem->IsExpectingMatchAssignment(GetWorld()))
+	{
+		return false;
+	}
+
+	EXPERIENCE_LOG(Log, TEXT("Waiting for a matchmaking assignment before loading an experience"));
+
+	MatchAssignmentHandle = ExperienceSubsystem->CallOrRegister_OnMatchAssignmentReceived(
+		FOnExperienceMatchAssignmentReceived::FDelegate::CreateUObject(this, &ThisClass::OnMatchAssignmentReceived));
+
+	return true;
+}
+
+void AModularExperienceGameModeBase::OnMatchAssignmentReceived(const FExperienceMatchAssignment& Assignment)
+{
+	MatchAssignmentHandle.Reset();
+
+	// Rerun the whole selection, it claims the assignment which then takes precedence over everything else
+	HandleMatchAssignmentIfNotExpectingOne();
+}
+
+void AModularExperienceGameModeBase::ApplyMatchAssignmentOptions(const FString& AssignmentOptions)
+{
+	if (AssignmentOptions.IsEmpty())
+	{
+		return;
+	}
+
+	// Options parsed later on see the assignment, the session picks up the ones it reads in InitOptions
+	OptionsString += AssignmentOptions.StartsWith(TEXT("?")) ? AssignmentOptions : (TEXT("?") + AssignmentOptions);
+	if (GameSession)
+	{
+		GameSession->InitOptions(OptionsString);
+	}
+
+	EXPERIENCE_LOG(Log, TEXT("Applied match assignment options '%s'"), *AssignmentOptions);
 }
 
 void AModularExperienceGameModeBase::InitGameState()
@@ -272,9 +452,9 @@ UClass* AModularExperienceGameModeBase::GetDefaultPawnClassForController_Impleme
 {
 	if (const UExperiencePawnData* PawnData = GetPawnDataForController(InController))
 	{
-		if (PawnData->PawnClass)
+		if (const TSubclassOf<APawn> PawnClass = UExperienceAssetManager::GetSubclass(PawnData->PawnClass))
 		{
-			return PawnData->PawnClass;
+			return PawnClass;
 		}
 	}
 	
@@ -321,6 +501,19 @@ APawn* AModularExperienceGameModeBase::SpawnDefaultPawnAtTransform_Implementatio
 
 AActor* AModularExperienceGameModeBase::ChoosePlayerStart_Implementation(AController* Player)
 {
+	if (UExperiencePlayerStartSubsystem* PlayerStartSubsystem = GetWorld()->GetSubsystem<UExperiencePlayerStartSubsystem>())
+	{
+		if (PlayerStartSubsystem->IsIndexBuilt())
+		{
+			if (APlayerStart* PlayerStart = PlayerStartSubsystem->ClaimPlayerStart(Player, GetPlayerStartTeamId(Player)))
+			{
+				return PlayerStart;
+			}
+
+			EXPERIENCE_LOG(Verbose, TEXT("All indexed player starts are blocked, falling back to the default search for %s."), *GetPathNameSafe(Player));
+		}
+	}
+
 	return Super::ChoosePlayerStart_Implementation(Player);
 }
 
@@ -337,55 +530,545 @@ void AModularExperienceGameModeBase::RequestPlayerRestartNextFrame(AController*
 	}
 }
 
+bool AModularExperienceGameModeBase::ResetMatch()
+{
+	if (!IsExperienceLoaded())
+	{
+		EXPERIENCE_LOG(Warning, TEXT("Can't reset the match before the experience has loaded."));
+		return false;
+	}
+
+	UExperienceManagerComponent* ExperienceMgr = UExperienceManagerComponent::Get(GameState);
+	check(ExperienceMgr);
+
+	if (ExperienceMgr->IsResettingExperienceActions())
+	{
+		EXPERIENCE_LOG(Warning, TEXT("Can't reset the match while the previous reset is still in progress."));
+		return false;
+	}
+
+	EXPERIENCE_LOG(Log, TEXT("Resetting the match in place."));
+	const double StartTime = FPlatformTime::Seconds();
+
+	// Work queued up for the previous round is meaningless now
+	AdmissionQueue.Reset();
+	AdmissionQueueHead = 0;
+	QueuedAdmissions.Reset();
+	PendingRestartRetries.Reset();
+	RestartRetryQueue.Reset();
+	RestartStats.NumPendingRetries = 0;
+
+	if (UExperiencePlayerStartSubsystem* PlayerStartSubsystem = GetWorld()->GetSubsystem<UExperiencePlayerStartSubsystem>())
+	{
+		PlayerStartSubsystem->ReleaseAllClaims();
+	}
+
+	// Gather the controllers first, destroying pawns while iterating would invalidate the iterator
+	TArray<AController*> Controllers;
+	for (FConstControllerIterator It = GetWorld()->GetControllerIterator(); It; ++It)
+	{
+		if (AController* Controller = It->Get())
+		{
+			Controllers.Add(Controller);
+		}
+	}
+
+	TArray<TWeakObjectPtr<AController>> ResetControllers;
+	TArray<TWeakObjectPtr<AController>> RecycledControllers;
+	for (AController* Controller : Controllers)
+	{
+		ResetControllers.Add(Controller);
+
+		APawn* Pawn = Controller->GetPawn();
+
+		AExperiencePlayerState* ExperiencePS = Controller->GetPlayerState<AExperiencePlayerState>();
+		const UExperiencePawnData* OldPawnData = ExperiencePS ? ExperiencePS->GetPawnData() : nullptr;
+		if (Controller->PlayerState)
+		{
+			Controller->PlayerState->Reset();
+		}
+
+		// Pick up the pawn data again, the experience may hand out different pawn data for the new round
+		if (ExperiencePS)
+		{
+			ExperiencePS->ResetPawnData();
+		}
+
+		if (Pawn == nullptr)
+		{
+			continue;
+		}
+
+		if (bRecyclePawnsOnMatchReset && ExperiencePS && ExperiencePS->GetPawnData() == OldPawnData)
+		{
+			RecycledControllers.Add(Controller);
+		}
+		else
+		{
+			Pawn->DetachFromControllerPendingDestroy();
+			Pawn->Destroy();
+		}
+	}
+
+	// Re-run the actions that opted in while no pawn is being spawned, then bring the players back
+	ExperienceMgr->ResetExperienceActions(FSimpleDelegate::CreateUObject(this, &ThisClass::FinishResetMatch, MoveTemp(ResetControllers), MoveTemp(RecycledControllers), StartTime));
+	return true;
+}
+
+void AModularExperienceGameModeBase::FinishResetMatch(TArray<TWeakObjectPtr<AController>> ResetControllers, TArray<TWeakObjectPtr<AController>> RecycledControllers, double StartTime)
+{
+	int32 NumRecycledPawns = 0;
+	for (const TWeakObjectPtr<AController>& Controller : RecycledControllers)
+	{
+		APawn* Pawn = Controller.IsValid() ? Controller->GetPawn() : nullptr;
+		if (Pawn == nullptr)
+		{
+			continue;
+		}
+
+		if (RecyclePawn(Controller.Get(), Pawn))
+		{
+			++NumRecycledPawns;
+		}
+		else
+		{
+			// Respawned with the others below
+			Pawn->DetachFromControllerPendingDestroy();
+			Pawn->Destroy();
+		}
+	}
+
+	// Players go through the admission queue, bots are restarted right away
+	for (const TWeakObjectPtr<AController>& WeakController : ResetControllers)
+	{
+		AController* Controller = WeakController.Get();
+		if (!IsValid(Controller) || Controller->GetPawn() != nullptr)
+		{
+			continue;
+		}
+
+		if (APlayerController* PC = Cast<APlayerController>(Controller))
+		{
+			PendingTimeToPawn.Add(PC, FPlatformTime::Seconds());
+			EnqueueAdmission(PC);
+		}
+		else if (ControllerCanRestart(Controller))
+		{
+			RestartPlayer(Controller);
+		}
+	}
+
+	ProcessAdmissionQueue();
+
+	EXPERIENCE_LOG(Log, TEXT("Match reset in %.3fs (%d pawns recycled)."), FPlatformTime::Seconds() - StartTime, NumRecycledPawns);
+
+	OnMatchReset.Broadcast(this);
+}
+
+bool AModularExperienceGameModeBase::RecyclePawn(AController* Controller, APawn* Pawn)
+{
+	// Only the pawn extension component knows how to bring the pawn back to its spawned state
+	UExperiencePawnExtensionComponent* PawnExtComp = UExperiencePawnExtensionComponent::FindPawnExtensionComponent(Pawn);
+	if (PawnExtComp == nullptr)
+	{
+		return false;
+	}
+
+	Pawn->Reset();
+	if (!IsValid(Pawn) || !PawnExtComp->ResetAbilitySystem())
+	{
+		EXPERIENCE_LOG(Verbose, TEXT("Pawn %s of %s couldn't be reset, respawning it instead."), *GetNameSafe(Pawn), *GetPathNameSafe(Controller));
+		return false;
+	}
+
+	// A respawn wouldn't find a start either, the reset pawn stays where it is
+	AActor* StartSpot = FindPlayerStart(Controller);
+	if (StartSpot == nullptr)
+	{
+		return true;
+	}
+
+	FRotator StartRotation(ForceInit);
+	StartRotation.Yaw = StartSpot->GetActorRotation().Yaw;
+
+	Pawn->TeleportTo(StartSpot->GetActorLocation(), StartRotation);
+	Controller->StartSpot = StartSpot;
+	Controller->SetControlRotation(StartRotation);
+	Controller->ClientSetRotation(StartRotation, true);
+
+	if (UExperiencePlayerStartSubsystem* PlayerStartSubsystem = GetWorld()->GetSubsystem<UExperiencePlayerStartSubsystem>())
+	{
+		PlayerStartSubsystem->SetClaimOccupant(Controller, Pawn);
+	}
+
+	return true;
+}
+
 void AModularExperienceGameModeBase::ToggleGameFeaturePlugin(FGameFeaturePluginURL& PluginURL, bool bEnable)
 {
 	FString ResolvedPluginURL;
 	UGameFeaturesSubsystem::Get().GetPluginURLByName(PluginURL.GetPluginName(), ResolvedPluginURL);
 
+	// Plugins are shared by every world in the process, only the game mode's own requests are dropped while others (e.g. the experience) still need it
+	if (!bEnable)
+	{
+		EnabledPluginURLs.Remove(ResolvedPluginURL);
+		if (!UExperienceManagerSubsystem::ReleasePluginRequests(ResolvedPluginURL, this))
+		{
+			EXPERIENCE_LOG(Log, TEXT("Not deactivating game feature plugin '%s', it is still requested."), *ResolvedPluginURL);
+			return;
+		}
+	}
+
 	if (bEnable)
 	{
+		// No need to unload a plugin that is wanted again
+		PluginsToUnloadPreWorldTick.Remove(ResolvedPluginURL);
+
+		if (!EnabledPluginURLs.Contains(ResolvedPluginURL))
+		{
+			EnabledPluginURLs.Add(ResolvedPluginURL);
+			UExperienceManagerSubsystem::NotifyOfPluginActivation(ResolvedPluginURL, this);
+		}
 		UGameFeaturesSubsystem::Get().LoadAndActivateGameFeaturePlugin(ResolvedPluginURL, FGameFeaturePluginLoadComplete());
 	}
-	else
+	else if (bCoalescePluginUnloads)
 	{
-		// Unloading plugins causes garbage collection to be triggered, so we need to wait until the next frame
+		// Stop the plugin from affecting gameplay right away, the expensive unload is batched
+		UGameFeaturesSubsystem::Get().DeactivateGameFeaturePlugin(ResolvedPluginURL);
 		PluginsToUnloadPreWorldTick.Add(ResolvedPluginURL);
-		if (!FWorldDelegates::OnWorldTickStart.IsBoundToObject(this))
+
+		if (!bPluginUnloadPurgeHeld && !GetWorldTimerManager().IsTimerActive(PluginUnloadWindowHandle))
 		{
-			FWorldDelegates::OnWorldTickStart.AddUObject(this, &ThisClass::UnloadPluginsPreWorldTick);
+			if (PluginUnloadCoalesceWindow > 0.f)
+			{
+				GetWorldTimerManager().SetTimer(PluginUnloadWindowHandle, this, &ThisClass::SchedulePluginUnloadPurge, PluginUnloadCoalesceWindow, false);
+			}
+			else
+			{
+				SchedulePluginUnloadPurge();
+			}
 		}
 	}
+	else
+	{
+		// Unloading plugins causes garbage collection to be triggered, so we need to wait until the next frame
+		PluginsToUnloadPreWorldTick.Add(ResolvedPluginURL);
+		SchedulePluginUnloadPurge();
+	}
+}
+
+void AModularExperienceGameModeBase::SetPluginUnloadPurgeHeld(bool bHeld)
+{
+	if (bPluginUnloadPurgeHeld == bHeld)
+	{
+		return;
+	}
+
+	bPluginUnloadPurgeHeld = bHeld;
+
+	if (bHeld)
+	{
+		GetWorldTimerManager().ClearTimer(PluginUnloadWindowHandle);
+		FWorldDelegates::OnWorldTickStart.RemoveAll(this);
+	}
+	else if (PluginsToUnloadPreWorldTick.Num() > 0)
+	{
+		SchedulePluginUnloadPurge();
+	}
+}
+
+void AModularExperienceGameModeBase::FlushPendingPluginUnloads()
+{
+	if (bPluginUnloadPurgeHeld)
+	{
+		EXPERIENCE_LOG(Verbose, TEXT("Not flushing %d pending plugin unloads, the purge is held."), PluginsToUnloadPreWorldTick.Num());
+		return;
+	}
+
+	GetWorldTimerManager().ClearTimer(PluginUnloadWindowHandle);
+
+	if (PluginsToUnloadPreWorldTick.Num() > 0)
+	{
+		SchedulePluginUnloadPurge();
+	}
+}
+
+void AModularExperienceGameModeBase::SchedulePluginUnloadPurge()
+{
+	if (!FWorldDelegates::OnWorldTickStart.IsBoundToObject(this))
+	{
+		FWorldDelegates::OnWorldTickStart.AddUObject(this, &ThisClass::UnloadPluginsPreWorldTick);
+	}
 }
 
 void AModularExperienceGameModeBase::UnloadPluginsPreWorldTick(UWorld* World, ELevelTick TickType, float DeltaSeconds)
 {
+	// The delegate fires for every world in the process
+	if (World != GetWorld())
+	{
+		return;
+	}
+
+	if (bCoalescePluginUnloads && PluginsToUnloadPreWorldTick.Num() > 0)
+	{
+		EXPERIENCE_LOG(Log, TEXT("Unloading %d coalesced game feature plugins."), PluginsToUnloadPreWorldTick.Num());
+	}
+
+	UnloadPendingPlugins();
+
+	// Remove the delegate now that we're done
+	FWorldDelegates::OnWorldTickStart.RemoveAll(this);
+}
+
+void AModularExperienceGameModeBase::UnloadPendingPlugins()
+{
+	if (PluginsToUnloadPreWorldTick.Num() == 0)
+	{
+		return;
+	}
+
 	for (const FString& URL : PluginsToUnloadPreWorldTick)
 	{
 		UGameFeaturesSubsystem::Get().UnloadGameFeaturePlugin(URL);
 	}
+
 	PluginsToUnloadPreWorldTick.Empty();
 
-	// Remove the delegate now that we're done
-	FWorldDelegates::OnWorldTickStart.RemoveAll(this);
+	// A single purge for the whole batch, instead of leaving it to whenever the engine gets to it
+	if (bCoalescePluginUnloads)
+	{
+		GEngine->ForceGarbageCollection(true);
+	}
 }
 
 bool AModularExperienceGameModeBase::ShouldSpawnAtStartSpot(AController* Player)
 {
+	// Go through ChoosePlayerStart when the starts are indexed, reusing an old start spot would bypass the occupancy tracking
+	if (const UExperiencePlayerStartSubsystem* PlayerStartSubsystem = GetWorld()->GetSubsystem<UExperiencePlayerStartSubsystem>())
+	{
+		if (PlayerStartSubsystem->IsIndexBuilt())
+		{
+			return false;
+		}
+	}
+
 	return Super::ShouldSpawnAtStartSpot(Player);
 }
 
 void AModularExperienceGameModeBase::HandleStartingNewPlayer_Implementation(APlayerController* NewPlayer)
 {
-	// Delay starting new players until the experience has been loaded
+	if (NewPlayer == nullptr)
+	{
+		return;
+	}
+
+	PruneTimeToPawn();
+	PendingTimeToPawn.FindOrAdd(NewPlayer, FPlatformTime::Seconds());
+
+	// Delay starting new players until the experience has been loaded and there is room in the admission budget
+	// Players that can't be admitted right away are queued and admitted in arrival order
+	if (IsExperienceLoaded() && !HasPendingAdmissions() && TryConsumeAdmissionBudget())
+	{
+		AdmitPlayer(NewPlayer);
+	}
+	else
+	{
+		EnqueueAdmission(NewPlayer);
+	}
+}
+
+void AModularExperienceGameModeBase::EnqueueAdmission(APlayerController* NewPlayer)
+{
+	bool bAlreadyQueued = false;
+	QueuedAdmissions.Add(NewPlayer, &bAlreadyQueued);
+	if (bAlreadyQueued)
+	{
+		return;
+	}
+
+	FPendingAdmission& Admission = AdmissionQueue.AddDefaulted_GetRef();
+	Admission.Controller = NewPlayer;
+	Admission.EnqueueTime = FPlatformTime::Seconds();
+
+	PendingTimeToPawn.FindOrAdd(NewPlayer, Admission.EnqueueTime);
+
+	AdmissionStats.QueueLength = QueuedAdmissions.Num();
+	AdmissionStats.PeakQueueLength = FMath::Max(AdmissionStats.PeakQueueLength, AdmissionStats.QueueLength);
+	SET_DWORD_STAT(STAT_ExperienceAdmissionQueueLength, AdmissionStats.QueueLength);
+
+	EXPERIENCE_LOG(Verbose, TEXT("Queued %s for admission (%d waiting)."), *GetPathNameSafe(NewPlayer), AdmissionStats.QueueLength);
+
+	// Nothing is admitted before the experience has loaded, OnExperienceLoaded starts ticking then
 	if (IsExperienceLoaded())
+	{
+		SetActorTickEnabled(true);
+	}
+}
+
+void AModularExperienceGameModeBase::ProcessAdmissionQueue()
+{
+	SCOPE_CYCLE_COUNTER(STAT_ExperienceProcessAdmissionQueue);
+
+	if (!HasPendingAdmissions() || !IsExperienceLoaded())
+	{
+		return;
+	}
+
+	while (AdmissionQueueHead < AdmissionQueue.Num())
+	{
+		APlayerController* PC = AdmissionQueue[AdmissionQueueHead].Controller.Get();
+
+		// Players that left while waiting don't use up the budget
+		if (PC == nullptr || PC->IsPendingKillPending())
+		{
+			++AdmissionQueueHead;
+			continue;
+		}
+
+		if (!TryConsumeAdmissionBudget())
+		{
+			break;
+		}
+
+		++AdmissionQueueHead;
+		QueuedAdmissions.Remove(PC);
+
+		EXPERIENCE_LOG(Verbose, TEXT("Admitting %s after %.2fs in the queue."),
+			*GetPathNameSafe(PC), FPlatformTime::Seconds() - AdmissionQueue[AdmissionQueueHead - 1].EnqueueTime);
+
+		AdmitPlayer(PC);
+	}
+
+	if (AdmissionQueueHead >= AdmissionQueue.Num())
+	{
+		AdmissionQueue.Reset();
+		AdmissionQueueHead = 0;
+
+		// Anything still in the set belonged to players that are gone
+		QueuedAdmissions.Reset();
+	}
+	else if (AdmissionQueueHead > 32 && AdmissionQueueHead * 2 > AdmissionQueue.Num())
+	{
+		AdmissionQueue.RemoveAt(0, AdmissionQueueHead, EAllowShrinking::No);
+		AdmissionQueueHead = 0;
+	}
+
+	AdmissionStats.QueueLength = QueuedAdmissions.Num();
+	SET_DWORD_STAT(STAT_ExperienceAdmissionQueueLength, AdmissionStats.QueueLength);
+}
+
+bool AModularExperienceGameModeBase::TryConsumeAdmissionBudget()
+{
+	return AdmissionBudget.TryConsume(MaxAdmissionsPerFrame, GFrameCounter);
+}
+
+void AModularExperienceGameModeBase::AdmitPlayer(APlayerController* NewPlayer)
+{
+	++AdmissionStats.NumAdmitted;
+
+	if (NewPlayer->GetPawn() == nullptr)
 	{
 		Super::HandleStartingNewPlayer_Implementation(NewPlayer);
 	}
+
+	// Spectators don't get a pawn, there is no time to pawn to measure
+	if (NewPlayer->GetPawn() == nullptr && !PendingRestartRetries.Contains(NewPlayer) && !PlayerCanRestart(NewPlayer))
+	{
+		ForgetTimeToPawn(NewPlayer);
+	}
+}
+
+void AModularExperienceGameModeBase::ForgetTimeToPawn(AController* Controller)
+{
+	if (PendingTimeToPawn.Remove(Controller) > 0)
+	{
+		EXPERIENCE_LOG(Verbose, TEXT("%s won't receive a pawn, no longer measuring its time to pawn."), *GetPathNameSafe(Controller));
+	}
+}
+
+void AModularExperienceGameModeBase::PruneTimeToPawn()
+{
+	for (auto It = PendingTimeToPawn.CreateIterator(); It; ++It)
+	{
+		AController* Controller = It.Key().ResolveObjectPtr();
+		if (Controller == nullptr)
+		{
+			It.RemoveCurrent();
+			continue;
+		}
+
+		const APlayerController* PC = Cast<APlayerController>(Controller);
+		const bool bWaitingForPawn = PendingRestartRetries.Contains(Controller) || (PC && QueuedAdmissions.Contains(PC));
+
+		// Possessed by something other than a restart, or switched to spectating only while waiting
+		const bool bOnlySpectating = Controller->PlayerState && Controller->PlayerState->IsOnlyASpectator();
+		if (bOnlySpectating || (!bWaitingForPawn && Controller->GetPawn() != nullptr))
+		{
+			It.RemoveCurrent();
+		}
+	}
+}
+
+FExperienceAdmissionStats AModularExperienceGameModeBase::GetAdmissionStats() const
+{
+	return AdmissionStats;
+}
+
+FExperienceRestartStats AModularExperienceGameModeBase::GetRestartStats() const
+{
+	return RestartStats;
+}
+
+void AModularExperienceGameModeBase::Tick(float DeltaSeconds)
+{
+	Super::Tick(DeltaSeconds);
+
+	ProcessAdmissionQueue();
+	ProcessBotFill();
+	ProcessRestartRetries();
+
+	if (!HasPendingTickWork())
+	{
+		SetActorTickEnabled(false);
+	}
+}
+
+bool AModularExperienceGameModeBase::HasPendingTickWork() const
+{
+	// Queued players wait for the experience without ticking
+	return (HasPendingAdmissions() && IsExperienceLoaded()) || PendingRestartRetries.Num() > 0 || SpawnedBots.Num() < NumBotsWanted;
 }
 
 void AModularExperienceGameModeBase::FinishRestartPlayer(AController* NewPlayer, const FRotator& StartRotation)
 {
 	Super::FinishRestartPlayer(NewPlayer, StartRotation);
+
+	if (UExperiencePlayerStartSubsystem* PlayerStartSubsystem = GetWorld()->GetSubsystem<UExperiencePlayerStartSubsystem>())
+	{
+		PlayerStartSubsystem->SetClaimOccupant(NewPlayer, NewPlayer->GetPawn());
+	}
+
+	if (NewPlayer->GetPawn())
+	{
+		PendingRestartRetries.Remove(NewPlayer);
+		RestartStats.NumPendingRetries = PendingRestartRetries.Num();
+	}
+
+	double StartTime = 0.0;
+	if (NewPlayer->GetPawn() && PendingTimeToPawn.RemoveAndCopyValue(NewPlayer, StartTime))
+	{
+		const float TimeToPawn = static_cast<float>(FPlatformTime::Seconds() - StartTime);
+		TotalTimeToPawn += TimeToPawn;
+
+		++AdmissionStats.NumSpawned;
+		AdmissionStats.LastTimeToPawn = TimeToPawn;
+		AdmissionStats.MaxTimeToPawn = FMath::Max(AdmissionStats.MaxTimeToPawn, TimeToPawn);
+		AdmissionStats.AverageTimeToPawn = static_cast<float>(TotalTimeToPawn / AdmissionStats.NumSpawned);
+		SET_FLOAT_STAT(STAT_ExperienceLastTimeToPawn, TimeToPawn);
+
+		EXPERIENCE_LOG(Verbose, TEXT("%s received a pawn %.2fs after starting."), *GetPathNameSafe(NewPlayer), TimeToPawn);
+	}
 }
 
 bool AModularExperienceGameModeBase::PlayerCanRestart_Implementation(APlayerController* Player)
@@ -410,22 +1093,36 @@ void AModularExperienceGameModeBase::FailedToRestartPlayer(AController* NewPlaye
 {
 	Super::FailedToRestartPlayer(NewPlayer);
 
+	++RestartStats.NumFailedRestarts;
+	INC_DWORD_STAT(STAT_ExperienceFailedRestarts);
+
+	// Free the start that was claimed for the failed spawn, the retry claims a new one
+	if (UExperiencePlayerStartSubsystem* PlayerStartSubsystem = GetWorld()->GetSubsystem<UExperiencePlayerStartSubsystem>())
+	{
+		PlayerStartSubsystem->ReleaseClaim(NewPlayer);
+	}
+
 	if (UClass* PawnClass = GetDefaultPawnClassForController(NewPlayer))
 	{
 		if (APlayerController* NewPC = Cast<APlayerController>(NewPlayer))
 		{
 			if (PlayerCanRestart(NewPC))
 			{
-				RequestPlayerRestartNextFrame(NewPlayer, false);
+				ScheduleRestartRetry(NewPlayer);
 			}
 			else
 			{
 				EXPERIENCE_LOG(Verbose, TEXT("Failed to restart player %s and PlayerCanRestart returned false."), *GetPathNameSafe(NewPlayer));
+				ForgetTimeToPawn(NewPlayer);
 			}
 		}
+		else if (bRetryBotRestarts)
+		{
+			ScheduleRestartRetry(NewPlayer);
+		}
 		else
 		{
-			RequestPlayerRestartNextFrame(NewPlayer, false);
+			EXPERIENCE_LOG(Verbose, TEXT("Failed to restart bot %s, bot restarts aren't retried."), *GetPathNameSafe(NewPlayer));
 		}
 	}
 	else
@@ -434,11 +1131,203 @@ void AModularExperienceGameModeBase::FailedToRestartPlayer(AController* NewPlaye
 	}
 }
 
+void AModularExperienceGameModeBase::ScheduleRestartRetry(AController* Controller)
+{
+	FPendingRestartRetry& Retry = PendingRestartRetries.FindOrAdd(Controller);
+	Retry.Controller = Controller;
+	++Retry.NumFailures;
+
+	if (MaxRestartRetries > 0 && Retry.NumFailures > MaxRestartRetries)
+	{
+		EXPERIENCE_LOG(Warning, TEXT("Giving up on restarting %s after %d failed attempts."), *GetPathNameSafe(Controller), Retry.NumFailures);
+
+		PendingRestartRetries.Remove(Controller);
+		RestartStats.NumPendingRetries = PendingRestartRetries.Num();
+		++RestartStats.NumAbandoned;
+		ForgetTimeToPawn(Controller);
+		return;
+	}
+
+	// Double the delay with every failure, the exponent is clamped to keep the math sane for controllers failing for a long time
+	const float Delay = FMath::Min(RestartRetryBaseDelay * FMath::Pow(2.f, static_cast<float>(FMath::Min(Retry.NumFailures - 1, 16))), RestartRetryMaxDelay);
+	Retry.NextAttemptTime = GetWorld()->GetRealTimeSeconds() + Delay;
+
+	// Any earlier attempt left in the queue no longer matches NextAttemptTime and is skipped when popped
+	RestartRetryQueue.Schedule(Controller, Retry.NextAttemptTime, GFrameCounter);
+
+	RestartStats.NumPendingRetries = PendingRestartRetries.Num();
+
+	EXPERIENCE_LOG(Verbose, TEXT("Retrying the restart of %s in %.2fs (failure %d)."), *GetPathNameSafe(Controller), Delay, Retry.NumFailures);
+
+	SetActorTickEnabled(true);
+}
+
+void AModularExperienceGameModeBase::ProcessRestartRetries()
+{
+	SCOPE_CYCLE_COUNTER(STAT_ExperienceProcessRestartRetries);
+
+	if (PendingRestartRetries.Num() == 0)
+	{
+		RestartRetryQueue.Reset();
+		return;
+	}
+
+	const double Now = GetWorld()->GetRealTimeSeconds();
+
+	// Pop the due attempts oldest first, skipping the ones that went stale
+	// Attempts scheduled during this frame, e.g. rescheduled with no delay, are held back for the next frame rather than retried again
+	int32 NumRetried = 0;
+	FExperienceRestartRetryQueue::FAttempt Attempt;
+	while ((MaxRestartRetriesPerFrame <= 0 || NumRetried < MaxRestartRetriesPerFrame) && RestartRetryQueue.PopDue(Now, GFrameCounter, Attempt))
+	{
+		FPendingRestartRetry* Retry = PendingRestartRetries.Find(Attempt.Controller);
+		if (Retry == nullptr || Retry->NextAttemptTime != Attempt.AttemptTime)
+		{
+			continue;
+		}
+
+		AController* Controller = Retry->Controller.Get();
+		if (Controller == nullptr || Controller->IsPendingKillPending())
+		{
+			PendingRestartRetries.Remove(Attempt.Controller);
+			continue;
+		}
+
+		++NumRetried;
+
+		// Push the next attempt out first, a failure reschedules it with a longer delay
+		Retry->NextAttemptTime = TNumericLimits<double>::Max();
+
+		++RestartStats.NumRetries;
+		INC_DWORD_STAT(STAT_ExperienceRestartRetries);
+
+		APlayerController* PC = Cast<APlayerController>(Controller);
+		const bool bCanRestart = PC ? PlayerCanRestart(PC) : ControllerCanRestart(Controller);
+		if (!bCanRestart || Controller->GetPawn() != nullptr)
+		{
+			PendingRestartRetries.Remove(Controller);
+			continue;
+		}
+
+		RestartPlayer(Controller);
+
+		// RestartPlayer doesn't report every failure (e.g. no start spot at all), treat an unresolved attempt as one
+		Retry = PendingRestartRetries.Find(Controller);
+		if (Retry && Retry->NextAttemptTime == TNumericLimits<double>::Max())
+		{
+			if (Controller->GetPawn() != nullptr)
+			{
+				PendingRestartRetries.Remove(Controller);
+			}
+			else
+			{
+				ScheduleRestartRetry(Controller);
+			}
+		}
+	}
+
+	RestartRetryQueue.EndPass();
+
+	RestartStats.NumPendingRetries = PendingRestartRetries.Num();
+}
+
+void AModularExperienceGameModeBase::Logout(AController* Exiting)
+{
+	Super::Logout(Exiting);
+
+	// The queue entry itself goes stale and is skipped
+	QueuedAdmissions.Remove(Cast<APlayerController>(Exiting));
+	PendingTimeToPawn.Remove(Exiting);
+	PendingRestartRetries.Remove(Exiting);
+	AdmissionStats.QueueLength = QueuedAdmissions.Num();
+	RestartStats.NumPendingRetries = PendingRestartRetries.Num();
+}
+
 void AModularExperienceGameModeBase::StartPlay()
 {
 	// Make sure level streaming is up to date before triggering NotifyMatchStarted
-	GEngine->BlockTillLevelStreamingCompleted(GetWorld());
-	
+	// Rather than blocking the game thread (and with it networking and the loading screen), wait for it asynchronously
+	if (IsStartPlayGateOpen())
+	{
+		Super::StartPlay();
+		return;
+	}
+
+	EXPERIENCE_LOG(Log, TEXT("Delaying StartPlay until level streaming and the experience load have completed."));
+
+	StartPlayGateBeginTime = FPlatformTime::Seconds();
+	StartPlayGateTimerHandle = GetWorldTimerManager().SetTimerForNextTick(this, &ThisClass::PollStartPlayGate);
+}
+
+bool AModularExperienceGameModeBase::IsStartPlayGateOpen() const
+{
+	if (UExperienceManagerComponent::IsLevelStreamingPending(GetWorld()))
+	{
+		return false;
+	}
+
+	return IsExperienceReadyForStartPlay();
+}
+
+bool AModularExperienceGameModeBase::IsExperienceReadyForStartPlay() const
+{
+	if (!bStartPlayWaitsForExperience)
+	{
+		return true;
+	}
+
+	// The experience isn't known until the match assignment has been given, keep waiting for it
+	if (!bMatchAssignmentGiven)
+	{
+		return false;
+	}
+
+	const UExperienceManagerComponent* ExperienceMgr = UExperienceManagerComponent::Get(GameState);
+	if (ExperienceMgr && ExperienceMgr->HasExperienceAssigned() && !ExperienceMgr->IsExperienceLoaded())
+	{
+		return false;
+	}
+
+	return true;
+}
+
+void AModularExperienceGameModeBase::PollStartPlayGate()
+{
+	StartPlayGateTimerHandle.Invalidate();
+
+	if (HasActorBegunPlay())
+	{
+		return;
+	}
+
+	if (!IsStartPlayGateOpen())
+	{
+		if (!bStartPlayGateTimedOut)
+		{
+			const double WaitTime = FPlatformTime::Seconds() - StartPlayGateBeginTime;
+			if (StartPlayGateTimeout <= 0.f || WaitTime < StartPlayGateTimeout)
+			{
+				StartPlayGateTimerHandle = GetWorldTimerManager().SetTimerForNextTick(this, &ThisClass::PollStartPlayGate);
+				return;
+			}
+
+			EXPERIENCE_LOG(Warning, TEXT("StartPlay gate still closed after %.1fs, blocking on level streaming."), WaitTime);
+			bStartPlayGateTimedOut = true;
+			GEngine->BlockTillLevelStreamingCompleted(GetWorld());
+		}
+
+		// Only level streaming is forced by the timeout, play never starts on an experience that is still loading
+		if (!IsExperienceReadyForStartPlay())
+		{
+			StartPlayGateTimerHandle = GetWorldTimerManager().SetTimerForNextTick(this, &ThisClass::PollStartPlayGate);
+			return;
+		}
+	}
+	else
+	{
+		EXPERIENCE_LOG(Log, TEXT("StartPlay gate opened after %.2fs."), FPlatformTime::Seconds() - StartPlayGateBeginTime);
+	}
+
 	Super::StartPlay();
 }
 
@@ -446,8 +1335,38 @@ void AModularExperienceGameModeBase::EndPlay(const EEndPlayReason::Type EndPlayR
 {
 	Super::EndPlay(EndPlayReason);
 
-	PluginsToUnloadPreWorldTick.Empty();
+	// Drop the requests for the plugins enabled through the game mode, deactivating those nobody else needs
+	for (const FString& PluginURL : EnabledPluginURLs)
+	{
+		if (UExperienceManagerSubsystem::ReleasePluginRequests(PluginURL, this))
+		{
+			UGameFeaturesSubsystem::Get().DeactivateGameFeaturePlugin(PluginURL);
+		}
+	}
+	EnabledPluginURLs.Empty();
+
+	// The world won't tick again, the plugins were deactivated already and the next world decides what gets unloaded
+	GetWorldTimerManager().ClearTimer(PluginUnloadWindowHandle);
 	FWorldDelegates::OnWorldTickStart.RemoveAll(this);
+	PluginsToUnloadPreWorldTick.Empty();
+
+	GetWorldTimerManager().ClearTimer(StartPlayGateTimerHandle);
+
+	AdmissionQueue.Empty();
+	AdmissionQueueHead = 0;
+	QueuedAdmissions.Empty();
+	PendingTimeToPawn.Empty();
+	PendingRestartRetries.Empty();
+	RestartRetryQueue.Reset();
+
+	if (MatchAssignmentHandle.IsValid())
+	{
+		UExperienceManagerSubsystem::Get()->Unregister_OnMatchAssignmentReceived(MatchAssignmentHandle);
+		MatchAssignmentHandle.Reset();
+	}
+
+	// The match is over, whatever this world hosts next gets its own assignment
+	UExperienceManagerSubsystem::Get()->ReleaseMatchAssignment(GetWorld());
 }
 
 bool AModularExperienceGameModeBase::ControllerCanRestart(AController* Controller)
@@ -470,7 +1389,25 @@ bool AModularExperienceGameModeBase::ControllerCanRestart(AController* Controlle
 	return true;
 }
 
+uint8 AModularExperienceGameModeBase::GetPlayerStartTeamId(const AController* Controller) const
+{
+	if (Controller == nullptr)
+	{
+		return UExperiencePlayerStartSubsystem::NoTeamId;
+	}
+
+	if (const IGenericTeamAgentInterface* TeamAgent = Cast<const IGenericTeamAgentInterface>(Controller))
+	{
+		return TeamAgent->GetGenericTeamId().GetId();
+	}
 
+	if (const IGenericTeamAgentInterface* TeamAgent = Cast<const IGenericTeamAgentInterface>(Controller->PlayerState))
+	{
+		return TeamAgent->GetGenericTeamId().GetId();
+	}
+
+	return UExperiencePlayerStartSubsystem::NoTeamId;
+}
 
 #if WITH_EDITOR
 EDataValidationResult AModularExperienceGameModeBase::IsDataValid(FDataValidationContext& Context) const
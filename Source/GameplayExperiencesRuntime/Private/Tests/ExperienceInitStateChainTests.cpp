@@ -0,0 +1,101 @@
+// Copyright © 2024 Playton. All Rights Reserved.
+
+
+#include "Components/ExperienceInitStateChain.h"
+
+#include "NativeGameplayTags.h"
+#include "Misc/AutomationTest.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+namespace ExperienceInitStateChainTests
+{
+	UE_DEFINE_GAMEPLAY_TAG_STATIC(TAG_Test_Spawned, "Test.GameplayExperiences.InitState.Spawned");
+	UE_DEFINE_GAMEPLAY_TAG_STATIC(TAG_Test_Available, "Test.GameplayExperiences.InitState.Available");
+	UE_DEFINE_GAMEPLAY_TAG_STATIC(TAG_Test_Initialized, "Test.GameplayExperiences.InitState.Initialized");
+	UE_DEFINE_GAMEPLAY_TAG_STATIC(TAG_Test_CosmeticsReady, "Test.GameplayExperiences.InitState.CosmeticsReady");
+	UE_DEFINE_GAMEPLAY_TAG_STATIC(TAG_Test_Ready, "Test.GameplayExperiences.InitState.Ready");
+	UE_DEFINE_GAMEPLAY_TAG_STATIC(TAG_Test_Unknown, "Test.GameplayExperiences.InitState.Unknown");
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FExperienceInitStateChainCompileTest, "GameplayExperiences.InitStateChain.Compile",
+	EAutomationTestFlags_ApplicationContextMask | EAutomationTestFlags::EngineFilter)
+
+bool FExperienceInitStateChainCompileTest::RunTest(const FString& Parameters)
+{
+	using namespace ExperienceInitStateChainTests;
+
+	FExperienceInitStateChain Chain;
+	FString Error;
+
+	TestTrue(TEXT("Chain with a project specific stage compiles"),
+		Chain.Compile({ TAG_Test_Spawned, TAG_Test_Available, TAG_Test_Initialized, TAG_Test_CosmeticsReady, TAG_Test_Ready }, Error));
+	TestTrue(TEXT("Compiled chain is valid"), Chain.IsValid());
+	TestEqual(TEXT("Stages of the compiled chain"), Chain.Num(), 5);
+
+	// Invalid chains are rejected and leave the chain empty
+	Error.Reset();
+	TestFalse(TEXT("Chain with too few states doesn't compile"), Chain.Compile({ TAG_Test_Spawned, TAG_Test_Available, TAG_Test_Ready }, Error));
+	TestFalse(TEXT("Chain with too few states reports an error"), Error.IsEmpty());
+	TestFalse(TEXT("Rejected chain isn't valid"), Chain.IsValid());
+	TestEqual(TEXT("Stages of the rejected chain"), Chain.Num(), 0);
+
+	Error.Reset();
+	TestFalse(TEXT("Chain with an empty state doesn't compile"),
+		Chain.Compile({ TAG_Test_Spawned, TAG_Test_Available, FGameplayTag(), TAG_Test_Ready }, Error));
+	TestFalse(TEXT("Chain with an empty state reports an error"), Error.IsEmpty());
+
+	Error.Reset();
+	TestFalse(TEXT("Chain with a duplicate state doesn't compile"),
+		Chain.Compile({ TAG_Test_Spawned, TAG_Test_Available, TAG_Test_Initialized, TAG_Test_Available, TAG_Test_Ready }, Error));
+	TestFalse(TEXT("Chain with a duplicate state reports an error"), Error.IsEmpty());
+	TestFalse(TEXT("Chain with a duplicate state isn't valid"), Chain.IsValid());
+
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FExperienceInitStateChainLookupTest, "GameplayExperiences.InitStateChain.Lookup",
+	EAutomationTestFlags_ApplicationContextMask | EAutomationTestFlags::EngineFilter)
+
+bool FExperienceInitStateChainLookupTest::RunTest(const FString& Parameters)
+{
+	using namespace ExperienceInitStateChainTests;
+
+	FExperienceInitStateChain Chain;
+	FString Error;
+	if (!Chain.Compile({ TAG_Test_Spawned, TAG_Test_Available, TAG_Test_Initialized, TAG_Test_CosmeticsReady, TAG_Test_Ready }, Error))
+	{
+		AddError(FString::Printf(TEXT("Chain didn't compile: %s"), *Error));
+		return false;
+	}
+
+	// Stages and states map onto each other
+	TestEqual(TEXT("Stage of Spawned"), Chain.GetStage(TAG_Test_Spawned), FExperienceInitStateChain::SpawnedStage);
+	TestEqual(TEXT("Stage of Available"), Chain.GetStage(TAG_Test_Available), FExperienceInitStateChain::AvailableStage);
+	TestEqual(TEXT("Stage of Initialized"), Chain.GetStage(TAG_Test_Initialized), FExperienceInitStateChain::InitializedStage);
+	TestEqual(TEXT("Stage of the project specific state"), Chain.GetStage(TAG_Test_CosmeticsReady), 3);
+	TestEqual(TEXT("Stage of Ready"), Chain.GetStage(TAG_Test_Ready), Chain.GetReadyStage());
+	TestEqual(TEXT("Ready is the last stage"), Chain.GetReadyStage(), 4);
+	TestEqual(TEXT("Stage of a state outside of the chain"), Chain.GetStage(TAG_Test_Unknown), INDEX_NONE);
+
+	TestTrue(TEXT("State of the ready stage"), Chain.GetState(Chain.GetReadyStage()) == TAG_Test_Ready);
+	TestFalse(TEXT("State of a stage past the chain"), Chain.GetState(Chain.Num()).IsValid());
+	TestFalse(TEXT("State of no stage"), Chain.GetState(INDEX_NONE).IsValid());
+
+	// Only stepping to the next stage is a transition
+	TestEqual(TEXT("No state to Spawned"), Chain.GetTransitionStage(FGameplayTag(), TAG_Test_Spawned), FExperienceInitStateChain::SpawnedStage);
+	TestEqual(TEXT("Spawned to Available"), Chain.GetTransitionStage(TAG_Test_Spawned, TAG_Test_Available), FExperienceInitStateChain::AvailableStage);
+	TestEqual(TEXT("Initialized to the project specific state"), Chain.GetTransitionStage(TAG_Test_Initialized, TAG_Test_CosmeticsReady), 3);
+	TestEqual(TEXT("Project specific state to Ready"), Chain.GetTransitionStage(TAG_Test_CosmeticsReady, TAG_Test_Ready), Chain.GetReadyStage());
+
+	TestEqual(TEXT("No state to Available skips Spawned"), Chain.GetTransitionStage(FGameplayTag(), TAG_Test_Available), INDEX_NONE);
+	TestEqual(TEXT("Initialized to Ready skips the project specific state"), Chain.GetTransitionStage(TAG_Test_Initialized, TAG_Test_Ready), INDEX_NONE);
+	TestEqual(TEXT("Available to Spawned goes backwards"), Chain.GetTransitionStage(TAG_Test_Available, TAG_Test_Spawned), INDEX_NONE);
+	TestEqual(TEXT("Ready to Ready stays in place"), Chain.GetTransitionStage(TAG_Test_Ready, TAG_Test_Ready), INDEX_NONE);
+	TestEqual(TEXT("State outside of the chain to Spawned"), Chain.GetTransitionStage(TAG_Test_Unknown, TAG_Test_Spawned), INDEX_NONE);
+	TestEqual(TEXT("Available to a state outside of the chain"), Chain.GetTransitionStage(TAG_Test_Available, TAG_Test_Unknown), INDEX_NONE);
+
+	return true;
+}
+
+#endif // WITH_DEV_AUTOMATION_TESTS
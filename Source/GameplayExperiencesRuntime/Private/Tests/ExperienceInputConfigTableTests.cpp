@@ -0,0 +1,163 @@
+// Copyright © 2024 Playton. All Rights Reserved.
+
+
+#include "Input/ExperienceInputConfigTable.h"
+
+#include "ExperiencePawnData.h"
+#include "InputAction.h"
+#include "NativeGameplayTags.h"
+#include "Actions/GameFeatureAction_AddInputConfig.h"
+#include "Misc/AutomationTest.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+namespace ExperienceInputConfigTableTests
+{
+	UE_DEFINE_GAMEPLAY_TAG_STATIC(TAG_Test_Move, "Test.GameplayExperiences.Input.Move");
+	UE_DEFINE_GAMEPLAY_TAG_STATIC(TAG_Test_Jump, "Test.GameplayExperiences.Input.Jump");
+	UE_DEFINE_GAMEPLAY_TAG_STATIC(TAG_Test_Fire, "Test.GameplayExperiences.Input.Fire");
+
+	struct FBinding
+	{
+		FGameplayTag Tag;
+		const UInputAction* InputAction = nullptr;
+	};
+
+	UInputConfig* NewInputConfig(const TCHAR* Name, TConstArrayView<FBinding> NativeBindings, TConstArrayView<FBinding> AbilityBindings = {})
+	{
+		UInputConfig* InputConfig = NewObject<UInputConfig>(GetTransientPackage(), MakeUniqueObjectName(GetTransientPackage(), UInputConfig::StaticClass(), Name));
+		for (const FBinding& Binding : NativeBindings)
+		{
+			FInputConfig_ActionBinding& ActionBinding = InputConfig->NativeInputActions.AddDefaulted_GetRef();
+			ActionBinding.InputAction = Binding.InputAction;
+			ActionBinding.GameplayTag = Binding.Tag;
+		}
+		for (const FBinding& Binding : AbilityBindings)
+		{
+			FInputConfig_ActionBinding& ActionBinding = InputConfig->AbilityInputActions.AddDefaulted_GetRef();
+			ActionBinding.InputAction = Binding.InputAction;
+			ActionBinding.GameplayTag = Binding.Tag;
+		}
+		return InputConfig;
+	}
+
+	UInputAction* NewInputAction(const TCHAR* Name)
+	{
+		return NewObject<UInputAction>(GetTransientPackage(), MakeUniqueObjectName(GetTransientPackage(), UInputAction::StaticClass(), Name));
+	}
+
+	UExperiencePawnData* NewPawnData(const TCHAR* Name, UInputConfig* InputConfig)
+	{
+		UExperiencePawnData* PawnData = NewObject<UExperiencePawnData>(GetTransientPackage(), MakeUniqueObjectName(GetTransientPackage(), UExperiencePawnData::StaticClass(), Name));
+		PawnData->InputConfig = InputConfig;
+		return PawnData;
+	}
+
+	FExperienceInputConfigEntry MakeEntry(const UInputConfig* InputConfig, int32 Priority, TConstArrayView<const UExperiencePawnData*> PawnData = {})
+	{
+		FExperienceInputConfigEntry Entry;
+		Entry.InputConfig = InputConfig;
+		Entry.Priority = Priority;
+		for (const UExperiencePawnData* Filter : PawnData)
+		{
+			Entry.PawnData.Add(Filter);
+		}
+		return Entry;
+	}
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FExperienceInputConfigTablePriorityTest, "GameplayExperiences.InputConfigTable.Priority",
+	EAutomationTestFlags_ApplicationContextMask | EAutomationTestFlags::EngineFilter)
+
+bool FExperienceInputConfigTablePriorityTest::RunTest(const FString& Parameters)
+{
+	using namespace ExperienceInputConfigTableTests;
+
+	const UInputAction* BaseMove = NewInputAction(TEXT("BaseMove"));
+	const UInputAction* BaseJump = NewInputAction(TEXT("BaseJump"));
+	const UInputAction* OverrideJump = NewInputAction(TEXT("OverrideJump"));
+	const UInputAction* LowJump = NewInputAction(TEXT("LowJump"));
+	const UInputAction* LowFire = NewInputAction(TEXT("LowFire"));
+	const UInputAction* AbilityFire = NewInputAction(TEXT("AbilityFire"));
+
+	UInputConfig* BaseConfig = NewInputConfig(TEXT("BaseConfig"), { { TAG_Test_Move, BaseMove }, { TAG_Test_Jump, BaseJump } });
+	const UInputConfig* OverrideConfig = NewInputConfig(TEXT("OverrideConfig"), { { TAG_Test_Jump, OverrideJump } }, { { TAG_Test_Fire, AbilityFire } });
+	const UInputConfig* LowConfig = NewInputConfig(TEXT("LowConfig"), { { TAG_Test_Jump, LowJump }, { TAG_Test_Fire, LowFire } });
+	const UExperiencePawnData* PawnData = NewPawnData(TEXT("PawnData"), BaseConfig);
+
+	// Listed lowest priority first, the table has to sort the contributions itself
+	const FExperienceInputConfigEntry Contributions[] = { MakeEntry(LowConfig, -1), MakeEntry(OverrideConfig, 1) };
+	const TSharedRef<const FExperienceInputConfigTable> Table = FExperienceInputConfigTable::Build(PawnData, Contributions);
+
+	TestTrue(TEXT("Base input config"), Table->GetBaseInputConfig() == BaseConfig);
+	TestTrue(TEXT("Higher priority config overrides the pawn data"), Table->FindNativeInputActionByTag(TAG_Test_Jump) == OverrideJump);
+	TestTrue(TEXT("Pawn data binding nobody overrides is kept"), Table->FindNativeInputActionByTag(TAG_Test_Move) == BaseMove);
+	TestTrue(TEXT("Lower priority config fills in unbound tags"), Table->FindNativeInputActionByTag(TAG_Test_Fire) == LowFire);
+	TestTrue(TEXT("Ability bindings are merged separately"), Table->FindAbilityInputActionByTag(TAG_Test_Fire) == AbilityFire);
+	TestEqual(TEXT("Native bindings, one per tag"), Table->GetNativeInputActions().Num(), 3);
+	TestEqual(TEXT("Ability bindings, one per tag"), Table->GetAbilityInputActions().Num(), 1);
+	TestTrue(TEXT("Overridden action has no tag"), !Table->FindTagForInputAction(BaseJump).IsValid());
+	TestTrue(TEXT("Tag of the winning action"), Table->FindTagForInputAction(OverrideJump) == TAG_Test_Jump);
+
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FExperienceInputConfigTableConflictTest, "GameplayExperiences.InputConfigTable.Conflict",
+	EAutomationTestFlags_ApplicationContextMask | EAutomationTestFlags::EngineFilter)
+
+bool FExperienceInputConfigTableConflictTest::RunTest(const FString& Parameters)
+{
+	using namespace ExperienceInputConfigTableTests;
+
+	const UInputAction* BaseJump = NewInputAction(TEXT("BaseJump"));
+	const UInputAction* FirstFire = NewInputAction(TEXT("FirstFire"));
+	const UInputAction* SecondJump = NewInputAction(TEXT("SecondJump"));
+	const UInputAction* SecondFire = NewInputAction(TEXT("SecondFire"));
+
+	UInputConfig* BaseConfig = NewInputConfig(TEXT("BaseConfig"), { { TAG_Test_Jump, BaseJump } });
+	const UInputConfig* FirstConfig = NewInputConfig(TEXT("FirstConfig"), { { TAG_Test_Fire, FirstFire } });
+	const UInputConfig* SecondConfig = NewInputConfig(TEXT("SecondConfig"), { { TAG_Test_Jump, SecondJump }, { TAG_Test_Fire, SecondFire } });
+	const UExperiencePawnData* PawnData = NewPawnData(TEXT("PawnData"), BaseConfig);
+
+	// Same priority bindings of the same tag are ambiguous and reported, the pawn data and then the earlier contribution win
+	AddExpectedError(TEXT("both with priority 0"), EAutomationExpectedErrorFlags::Contains, 2);
+
+	const FExperienceInputConfigEntry Contributions[] = { MakeEntry(FirstConfig, 0), MakeEntry(SecondConfig, 0) };
+	const TSharedRef<const FExperienceInputConfigTable> Table = FExperienceInputConfigTable::Build(PawnData, Contributions);
+
+	TestTrue(TEXT("Pawn data wins over a contribution of the same priority"), Table->FindNativeInputActionByTag(TAG_Test_Jump) == BaseJump);
+	TestTrue(TEXT("Earlier contribution wins over a later one of the same priority"), Table->FindNativeInputActionByTag(TAG_Test_Fire) == FirstFire);
+
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FExperienceInputConfigTablePawnDataFilterTest, "GameplayExperiences.InputConfigTable.PawnDataFilter",
+	EAutomationTestFlags_ApplicationContextMask | EAutomationTestFlags::EngineFilter)
+
+bool FExperienceInputConfigTablePawnDataFilterTest::RunTest(const FString& Parameters)
+{
+	using namespace ExperienceInputConfigTableTests;
+
+	const UInputAction* FilteredJump = NewInputAction(TEXT("FilteredJump"));
+	const UInputAction* SharedFire = NewInputAction(TEXT("SharedFire"));
+
+	const UInputConfig* FilteredConfig = NewInputConfig(TEXT("FilteredConfig"), { { TAG_Test_Jump, FilteredJump } });
+	const UInputConfig* SharedConfig = NewInputConfig(TEXT("SharedConfig"), { { TAG_Test_Fire, SharedFire } });
+	const UExperiencePawnData* HeroPawnData = NewPawnData(TEXT("HeroPawnData"), NewInputConfig(TEXT("HeroConfig"), {}));
+	const UExperiencePawnData* OtherPawnData = NewPawnData(TEXT("OtherPawnData"), NewInputConfig(TEXT("OtherConfig"), {}));
+
+	// Listed pawn data only get the config, no pawn data means every pawn data gets it
+	const FExperienceInputConfigEntry Contributions[] = { MakeEntry(FilteredConfig, 1, { HeroPawnData }), MakeEntry(SharedConfig, 1) };
+
+	const TSharedRef<const FExperienceInputConfigTable> HeroTable = FExperienceInputConfigTable::Build(HeroPawnData, Contributions);
+	TestTrue(TEXT("Listed pawn data gets the filtered config"), HeroTable->FindNativeInputActionByTag(TAG_Test_Jump) == FilteredJump);
+	TestTrue(TEXT("Listed pawn data gets the shared config"), HeroTable->FindNativeInputActionByTag(TAG_Test_Fire) == SharedFire);
+
+	const TSharedRef<const FExperienceInputConfigTable> OtherTable = FExperienceInputConfigTable::Build(OtherPawnData, Contributions);
+	TestNull(TEXT("Unlisted pawn data doesn't get the filtered config"), OtherTable->FindNativeInputActionByTag(TAG_Test_Jump));
+	TestTrue(TEXT("Unlisted pawn data gets the shared config"), OtherTable->FindNativeInputActionByTag(TAG_Test_Fire) == SharedFire);
+
+	return true;
+}
+
+#endif // WITH_DEV_AUTOMATION_TESTS
@@ -0,0 +1,145 @@
+// Copyright © 2024 Playton. All Rights Reserved.
+
+
+#include "GameFramework/ExperiencePlayerStartSubsystem.h"
+
+#include "AIController.h"
+#include "Engine/Engine.h"
+#include "Engine/World.h"
+#include "GameFramework/PlayerStart.h"
+#include "Misc/AutomationTest.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+namespace ExperiencePlayerStartSubsystemTests
+{
+	/** Game world the subsystem is created for, torn down when the test is done. */
+	struct FTestWorld
+	{
+		FTestWorld()
+		{
+			World = UWorld::CreateWorld(EWorldType::Game, false);
+			FWorldContext& WorldContext = GEngine->CreateNewWorldContext(EWorldType::Game);
+			WorldContext.SetCurrentWorld(World);
+		}
+
+		~FTestWorld()
+		{
+			GEngine->DestroyWorldContext(World);
+			World->DestroyWorld(false);
+		}
+
+		template <typename ActorType>
+		ActorType* Spawn(const FVector& Location = FVector::ZeroVector)
+		{
+			FActorSpawnParameters SpawnParameters;
+			SpawnParameters.SpawnCollisionHandlingOverride = ESpawnActorCollisionHandlingMethod::AlwaysSpawn;
+			return World->SpawnActor<ActorType>(Location, FRotator::ZeroRotator, SpawnParameters);
+		}
+
+		UWorld* World = nullptr;
+	};
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FExperiencePlayerStartClaimTest, "GameplayExperiences.PlayerStarts.Claim",
+	EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+
+bool FExperiencePlayerStartClaimTest::RunTest(const FString& Parameters)
+{
+	using namespace ExperiencePlayerStartSubsystemTests;
+
+	FTestWorld TestWorld;
+
+	UExperiencePlayerStartSubsystem* Subsystem = TestWorld.World->GetSubsystem<UExperiencePlayerStartSubsystem>();
+	if (!TestNotNull(TEXT("Player start subsystem"), Subsystem))
+	{
+		return false;
+	}
+
+	// Far enough apart for a claim to only block the start it was made on
+	for (int32 Idx = 0; Idx < 3; ++Idx)
+	{
+		TestWorld.Spawn<APlayerStart>(FVector(Idx * 1000.0, 0.0, 0.0));
+	}
+
+	FExperiencePlayerStartSettings Settings;
+	Settings.ClaimCooldown = 60.f;
+	Settings.OccupancyRadius = 100.f;
+	Subsystem->BuildIndex(Settings);
+	TestEqual(TEXT("Indexed player starts"), Subsystem->GetNumIndexedPlayerStarts(), 3);
+
+	AController* Controllers[4];
+	for (AController*& Controller : Controllers)
+	{
+		Controller = TestWorld.Spawn<AAIController>();
+	}
+
+	// Every controller gets a start of its own until they run out
+	TSet<APlayerStart*> ClaimedStartSet;
+	APlayerStart* ClaimedStarts[3];
+	for (int32 Idx = 0; Idx < 3; ++Idx)
+	{
+		ClaimedStarts[Idx] = Subsystem->ClaimPlayerStart(Controllers[Idx], UExperiencePlayerStartSubsystem::NoTeamId);
+		TestNotNull(TEXT("Claimed player start"), ClaimedStarts[Idx]);
+		ClaimedStartSet.Add(ClaimedStarts[Idx]);
+	}
+	TestEqual(TEXT("Distinct claimed player starts"), ClaimedStartSet.Num(), 3);
+	TestNull(TEXT("Player start claimed once every start is blocked"), Subsystem->ClaimPlayerStart(Controllers[3], UExperiencePlayerStartSubsystem::NoTeamId));
+
+	// Releasing a claim frees its start right away, without waiting for the cooldown
+	Subsystem->ReleaseClaim(Controllers[1]);
+	TestTrue(TEXT("Player start claimed after a release is the released one"), Subsystem->ClaimPlayerStart(Controllers[3], UExperiencePlayerStartSubsystem::NoTeamId) == ClaimedStarts[1]);
+
+	// A claim is only released once
+	Subsystem->ReleaseClaim(Controllers[1]);
+	TestNull(TEXT("Player start claimed after releasing a claim twice"), Subsystem->ClaimPlayerStart(Controllers[1], UExperiencePlayerStartSubsystem::NoTeamId));
+
+	// Once a pawn has been spawned on the start, the claim runs its course
+	Subsystem->SetClaimOccupant(Controllers[0], nullptr);
+	Subsystem->ReleaseClaim(Controllers[0]);
+	TestNull(TEXT("Player start claimed after releasing an occupied claim"), Subsystem->ClaimPlayerStart(Controllers[1], UExperiencePlayerStartSubsystem::NoTeamId));
+
+	Subsystem->ReleaseAllClaims();
+	TestNotNull(TEXT("Player start claimed after releasing every claim"), Subsystem->ClaimPlayerStart(Controllers[1], UExperiencePlayerStartSubsystem::NoTeamId));
+
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FExperiencePlayerStartNeighboursTest, "GameplayExperiences.PlayerStarts.Neighbours",
+	EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+
+bool FExperiencePlayerStartNeighboursTest::RunTest(const FString& Parameters)
+{
+	using namespace ExperiencePlayerStartSubsystemTests;
+
+	FTestWorld TestWorld;
+
+	UExperiencePlayerStartSubsystem* Subsystem = TestWorld.World->GetSubsystem<UExperiencePlayerStartSubsystem>();
+	if (!TestNotNull(TEXT("Player start subsystem"), Subsystem))
+	{
+		return false;
+	}
+
+	// Close enough for a pawn spawned on one to overlap the other
+	TestWorld.Spawn<APlayerStart>(FVector(0.0, 0.0, 0.0));
+	TestWorld.Spawn<APlayerStart>(FVector(50.0, 0.0, 0.0));
+
+	FExperiencePlayerStartSettings Settings;
+	Settings.ClaimCooldown = 60.f;
+	Settings.OccupancyRadius = 100.f;
+	Subsystem->BuildIndex(Settings);
+
+	AController* FirstController = TestWorld.Spawn<AAIController>();
+	AController* SecondController = TestWorld.Spawn<AAIController>();
+
+	TestNotNull(TEXT("Claimed player start"), Subsystem->ClaimPlayerStart(FirstController, UExperiencePlayerStartSubsystem::NoTeamId));
+	TestNull(TEXT("Player start claimed next to a claimed one"), Subsystem->ClaimPlayerStart(SecondController, UExperiencePlayerStartSubsystem::NoTeamId));
+
+	// Releasing the claim frees its neighbours too
+	Subsystem->ReleaseClaim(FirstController);
+	TestNotNull(TEXT("Player start claimed next to a released one"), Subsystem->ClaimPlayerStart(SecondController, UExperiencePlayerStartSubsystem::NoTeamId));
+
+	return true;
+}
+
+#endif // WITH_DEV_AUTOMATION_TESTS
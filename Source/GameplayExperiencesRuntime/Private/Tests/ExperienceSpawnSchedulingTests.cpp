@@ -0,0 +1,97 @@
+// Copyright © 2024 Playton. All Rights Reserved.
+
+
+#include "GameFramework/ExperienceSpawnScheduling.h"
+
+#include "Misc/AutomationTest.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FExperienceAdmissionBudgetTest, "GameplayExperiences.SpawnScheduling.AdmissionBudget",
+	EAutomationTestFlags_ApplicationContextMask | EAutomationTestFlags::EngineFilter)
+
+bool FExperienceAdmissionBudgetTest::RunTest(const FString& Parameters)
+{
+	FExperienceAdmissionBudget Budget;
+
+	// Admits up to the limit within a frame
+	TestTrue(TEXT("First admission of the frame is allowed"), Budget.TryConsume(2, 10));
+	TestTrue(TEXT("Second admission of the frame is allowed"), Budget.TryConsume(2, 10));
+	TestFalse(TEXT("Third admission of the frame is refused"), Budget.TryConsume(2, 10));
+	TestEqual(TEXT("Consumed admissions of the frame"), Budget.GetNumConsumed(10), 2);
+
+	// Refills with the next frame
+	TestEqual(TEXT("Nothing consumed in a frame that hasn't been seen"), Budget.GetNumConsumed(11), 0);
+	TestTrue(TEXT("Admission of the next frame is allowed"), Budget.TryConsume(2, 11));
+	TestEqual(TEXT("Consumed admissions of the next frame"), Budget.GetNumConsumed(11), 1);
+
+	// No limit never runs out and doesn't count
+	FExperienceAdmissionBudget UnlimitedBudget;
+	for (int32 Idx = 0; Idx < 100; ++Idx)
+	{
+		if (!UnlimitedBudget.TryConsume(0, 10))
+		{
+			AddError(FString::Printf(TEXT("Admission %d was refused without a limit"), Idx));
+			break;
+		}
+	}
+	TestEqual(TEXT("Admissions without a limit aren't counted"), UnlimitedBudget.GetNumConsumed(10), 0);
+
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FExperienceRestartRetryQueueTest, "GameplayExperiences.SpawnScheduling.RestartRetryQueue",
+	EAutomationTestFlags_ApplicationContextMask | EAutomationTestFlags::EngineFilter)
+
+bool FExperienceRestartRetryQueueTest::RunTest(const FString& Parameters)
+{
+	using FAttempt = FExperienceRestartRetryQueue::FAttempt;
+
+	// The queue only orders attempts, matching them to live controllers is up to the game mode
+	const TObjectKey<AController> Controller;
+
+	FExperienceRestartRetryQueue Queue;
+	Queue.Schedule(Controller, 3.0, 1);
+	Queue.Schedule(Controller, 1.0, 1);
+	Queue.Schedule(Controller, 2.0, 1);
+	Queue.Schedule(Controller, 10.0, 1);
+	TestEqual(TEXT("Scheduled attempts"), Queue.Num(), 4);
+
+	// Due attempts come out by time, whatever order they were scheduled in, and later ones stay queued
+	TArray<double> PoppedTimes;
+	FAttempt Attempt;
+	while (Queue.PopDue(5.0, 2, Attempt))
+	{
+		PoppedTimes.Add(Attempt.AttemptTime);
+	}
+	Queue.EndPass();
+
+	TestTrue(TEXT("Due attempts are popped by time"), PoppedTimes == TArray<double>({ 1.0, 2.0, 3.0 }));
+	TestEqual(TEXT("Attempts left after the pass"), Queue.Num(), 1);
+	TestFalse(TEXT("Nothing else is due"), Queue.PopDue(5.0, 3, Attempt));
+	Queue.EndPass();
+
+	// An attempt rescheduled with no delay during a pass waits for the next frame instead of being retried in the same pass
+	Queue.Schedule(Controller, 5.0, 4);
+	TestFalse(TEXT("Attempt scheduled this frame is held back"), Queue.PopDue(5.0, 4, Attempt));
+	TestEqual(TEXT("Held back attempt is still counted"), Queue.Num(), 2);
+	Queue.EndPass();
+
+	TestTrue(TEXT("Held back attempt is due the next frame"), Queue.PopDue(5.0, 5, Attempt));
+	TestEqual(TEXT("Held back attempt time"), Attempt.AttemptTime, 5.0);
+	Queue.EndPass();
+
+	// Reset drops the queued and the held back attempts
+	Queue.Schedule(Controller, 6.0, 6);
+	TestTrue(TEXT("Attempt scheduled in an earlier frame is due"), Queue.PopDue(20.0, 6, Attempt));
+	TestEqual(TEXT("Attempt scheduled in an earlier frame time"), Attempt.AttemptTime, 10.0);
+	TestFalse(TEXT("Attempt scheduled this frame is held back"), Queue.PopDue(20.0, 6, Attempt));
+	Queue.Reset();
+	TestEqual(TEXT("Attempts left after a reset"), Queue.Num(), 0);
+	Queue.EndPass();
+	TestFalse(TEXT("Nothing is due after a reset"), Queue.PopDue(20.0, 7, Attempt));
+
+	return true;
+}
+
+#endif // WITH_DEV_AUTOMATION_TESTS
@@ -0,0 +1,65 @@
+// Copyright © 2024 Playton. All Rights Reserved.
+
+#pragma once
+
+#include "ModularAbilitySystemComponent.h"
+
+#include "ExperienceAbilitySystemComponent.generated.h"
+
+class UModularAbilityTagRelationshipMapping;
+
+/**
+ * Tag relationships of a mapping, resolved once per set of ability tags.
+ * Walking the relationships of a mapping is replaced by a single lookup for every ability after its first activation.
+ * Compiled mappings are shared by every ability system component using them, and dropped once no world hosts an experience anymore.
+ */
+class GAMEPLAYEXPERIENCESRUNTIME_API FExperienceCompiledTagRelationships
+{
+public:
+	/** Tags an ability blocks, cancels, requires and is blocked by, merged from every relationship matching its ability tags. */
+	struct FEntry
+	{
+		FGameplayTagContainer AbilityTags;
+		FGameplayTagContainer TagsToBlock;
+		FGameplayTagContainer TagsToCancel;
+		FGameplayTagContainer ActivationRequired;
+		FGameplayTagContainer ActivationBlocked;
+	};
+
+	/** Returns the compiled relationships of the mapping. */
+	static FExperienceCompiledTagRelationships& Get(const UModularAbilityTagRelationshipMapping* Mapping);
+
+	/** Drops every compiled mapping. */
+	static void Reset();
+
+	/** Returns the relationships of an ability with the given tags, resolving them on first use. */
+	const FEntry& FindOrCompile(const FGameplayTagContainer& AbilityTags);
+
+private:
+	TWeakObjectPtr<const UModularAbilityTagRelationshipMapping> Mapping;
+
+	/** Entries per hash of their ability tags. */
+	TMultiMap<uint32, FEntry> Entries;
+};
+
+/**
+ * Modular ability system component using compiled tag relationship mappings.
+ * Use as the ability system component of pawns or player states to avoid re-evaluating the mapping on every activation.
+ */
+UCLASS()
+class GAMEPLAYEXPERIENCESRUNTIME_API UExperienceAbilitySystemComponent : public UModularAbilitySystemComponent
+{
+	GENERATED_BODY()
+
+public:
+	UExperienceAbilitySystemComponent(const FObjectInitializer& ObjectInitializer = FObjectInitializer::Get());
+
+	//~ Begin UModularAbilitySystemComponent Interface
+	virtual void GetAdditionalActivationTagRequirements(const FGameplayTagContainer& AbilityTags, FGameplayTagContainer& OutActivationRequired, FGameplayTagContainer& OutActivationBlocked) const override;
+	//~ End UModularAbilitySystemComponent Interface
+
+protected:
+	//~ Begin UAbilitySystemComponent Interface
+	virtual void ApplyAbilityBlockAndCancelTags(const FGameplayTagContainer& AbilityTags, UGameplayAbility* RequestingAbility, bool bEnableBlockTags, const FGameplayTagContainer& BlockTags, bool bExecuteCancelTags, const FGameplayTagContainer& CancelTags) override;
+	//~ End UAbilitySystemComponent Interface
+};
@@ -0,0 +1,26 @@
+// Copyright © 2024 Playton. All Rights Reserved.
+
+#pragma once
+
+#include "UObject/Interface.h"
+
+#include "ExperienceResettableAction.generated.h"
+
+UINTERFACE(MinimalAPI, meta = (CannotImplementInterfaceInBlueprint))
+class UExperienceResettableAction : public UInterface
+{
+	GENERATED_BODY()
+};
+
+/**
+ * Implemented by game feature actions that want to be re-run when the match is reset in place.
+ * Opted-in actions are deactivated and activated again for the world, while the experience and its plugins stay loaded.
+ */
+class GAMEPLAYEXPERIENCESRUNTIME_API IExperienceResettableAction
+{
+	GENERATED_BODY()
+
+public:
+	/** Returns true if the action should be re-run on this reset. */
+	virtual bool ShouldResetOnMatchReset() const { return true; }
+};
@@ -0,0 +1,60 @@
+// Copyright © 2024 Playton. All Rights Reserved.
+
+#pragma once
+
+#include "GameFeatureAction.h"
+
+#include "GameFeatureAction_AddInputConfig.generated.h"
+
+class UExperiencePawnData;
+class UInputConfig;
+
+/**
+ * An input config contributed to the pawns of an experience.
+ */
+USTRUCT()
+struct FExperienceInputConfigEntry
+{
+	GENERATED_BODY()
+
+public:
+	/** Input config merged into the one of the pawn data. Only loaded with the client bundle of the experience. */
+	UPROPERTY(EditAnywhere, Category = "Input", meta = (AssetBundles = "Client"))
+	TSoftObjectPtr<const UInputConfig> InputConfig;
+
+	/** When several configs bind the same tag, the binding of the config with the highest priority is kept. The input config of the pawn data has priority 0. */
+	UPROPERTY(EditAnywhere, Category = "Input")
+	int32 Priority = 0;
+
+	/** Pawn data the config is merged into, matched by path so listing them doesn't load them. Empty means every pawn data. */
+	UPROPERTY(EditAnywhere, Category = "Input")
+	TArray<TSoftObjectPtr<const UExperiencePawnData>> PawnData;
+};
+
+/**
+ * Contributes input configs to the pawns of the experience, on top of the input config of their pawn data.
+ * Contributions of the experience and its action sets are merged into one input config table per pawn data when the experience loads.
+ * Only takes effect when listed in the actions of an experience or of one of its action sets.
+ */
+UCLASS(MinimalAPI, meta = (DisplayName = "Add Input Config"))
+class UGameFeatureAction_AddInputConfig : public UGameFeatureAction
+{
+	GENERATED_BODY()
+
+public:
+	//~ Begin UGameFeatureAction Interface
+#if WITH_EDITORONLY_DATA
+	virtual void AddAdditionalAssetBundleData(FAssetBundleData& AssetBundleData) override;
+#endif
+	//~ End UGameFeatureAction Interface
+
+	//~ Begin UObject Interface
+#if WITH_EDITOR
+	virtual EDataValidationResult IsDataValid(class FDataValidationContext& Context) const override;
+#endif
+	//~ End UObject Interface
+
+public:
+	UPROPERTY(EditAnywhere, Category = "Input", meta = (TitleProperty = "{InputConfig} ({Priority})"))
+	TArray<FExperienceInputConfigEntry> InputConfigs;
+};
@@ -6,11 +6,14 @@
 #include "GameFeatureAction_AddInputMappingContext.h"
 #include "Components/GameFrameworkInitStateInterface.h"
 #include "Components/PawnComponent.h"
+#include "GameFramework/InputDeviceSubsystem.h"
 
 #include "ExperienceHeroComponent.generated.h"
 
 
+class FExperienceInputConfigTable;
 class UInputConfig;
+class UInputMappingContext;
 
 namespace EEndPlayReason { enum Type : int; }
 struct FLoadedMappableConfigPair;
@@ -24,6 +27,23 @@ struct FFrame;
 struct FGameplayTag;
 struct FInputActionValue;
 
+/**
+ * Input mapping context only used while the player is on a given class of input device.
+ */
+USTRUCT()
+struct FExperienceDeviceInputMapping
+{
+	GENERATED_BODY()
+
+public:
+	/** Class of device the context is used with. Unspecified means every device. */
+	UPROPERTY(EditAnywhere, Category = "Input")
+	EHardwareDevicePrimaryType DeviceType = EHardwareDevicePrimaryType::Unspecified;
+
+	UPROPERTY(EditAnywhere, Category = "Input", meta = (ShowOnlyInnerProperties))
+	FInputMappingContextAndPriority Mapping;
+};
+
 /**
  * Basic hero component for player-controlled pawns that sets up input and camera handling.
  * Depends on the UExperiencePawnExtensionComponent to coordinate initialization.
@@ -46,6 +66,12 @@ public:
 	/** True if this is controlled by a real player and has progressed far enough in initialization where additional input bindings can be added. */
 	bool IsReadyToBindInputs() const { return bReadyToBindInputs; }
 
+	/** Returns the input mappings given to the input component, on top of the ones of the input config. */
+	const TArray<FInputMappingContextAndPriority>& GetDefaultInputMappings() const { return DefaultInputMappings; }
+
+	/** Returns the input mappings only given to the input component while the player is on their class of device. */
+	const TArray<FExperienceDeviceInputMapping>& GetDeviceInputMappings() const { return DeviceInputMappings; }
+
 	//~ Begin IGameFrameworkInitStateInterface interface
 	virtual FName GetFeatureName() const override { return NAME_ActorFeatureName; }
 	virtual bool CanChangeInitState(UGameFrameworkComponentManager* Manager, FGameplayTag CurrentState, FGameplayTag DesiredState) const override;
@@ -54,12 +80,67 @@ public:
 	virtual void CheckDefaultInitialization() override;
 	//~ End IGameFrameworkInitStateInterface interface
 
+	/**
+	 * Returns the input config table the player input was initialized with, merging the input config of the pawn data with the ones contributed by the experience.
+	 * Null until the player input has been initialized.
+	 */
+	const FExperienceInputConfigTable* GetInputConfigTable() const { return InputConfigTable.Get(); }
+
 	/** Initializes the player input with the given input component. */
 	void InitializePlayerInput(UInputComponent* InputComponent);
-	virtual void OnInitializePlayerInput(UInputComponent* InputComponent, const UInputConfig* InputConfig) {}
+
+	/**
+	 * Override to bind the player input. Bindings should come from the table, which has the contributions of the experience merged in.
+	 * The input config of the pawn data is null if the pawn data doesn't have one, the table is null if the experience didn't build one.
+	 */
+	virtual void OnInitializePlayerInput(UInputComponent* InputComponent, const UInputConfig* InputConfig, const FExperienceInputConfigTable* InInputConfigTable) {}
 	virtual void OnDataInitialized(const class UExperiencePawnData* PawnData) {}
 
 protected:
+	/**
+	 * Returns true if the feature can enter the given stage of the init state chain, coming from the previous one.
+	 * Override to add conditions for project specific stages, which can otherwise be entered right away.
+	 */
+	virtual bool CanEnterInitStage(UGameFrameworkComponentManager* Manager, int32 Stage) const;
+
+	/** Returns true if the pawn is controlled by a local player, and will need its input initialized. */
+	bool IsLocalPlayerPawn() const;
+
+	/** Returns the input config table of the pawn data, if the experience has loaded. */
+	TSharedPtr<const FExperienceInputConfigTable> FindInputConfigTable(const class UExperiencePawnData* PawnData) const;
+
+	/** Gathers the input mappings of the hero component and of the input configs of the pawn data, and optionally the ones of the active device. */
+	void GatherInputMappings(const class UExperiencePawnData* PawnData, TArray<FInputMappingContextAndPriority>& OutMappings, bool bIncludeDeviceMappings = true) const;
+
+	/** Gathers the device input mappings of the active class of device. */
+	void GatherDeviceInputMappings(TArray<FInputMappingContextAndPriority>& OutMappings) const;
+
+	/** Returns true once every input mapping context the player input is initialized with has been loaded. */
+	bool AreInputMappingsLoaded() const;
+
+	/** Returns true if the input asset still has to be loaded. Assets that failed to load are given up on, not waited for. */
+	bool IsInputAssetPending(const FSoftObjectPath& Path) const;
+
+	/** Starts streaming the input mapping contexts that haven't been loaded with the experience, initialization waits on them. */
+	void LoadInputMappings();
+	void OnInputMappingsLoaded(TArray<FSoftObjectPath> RequestedPaths);
+
+	/** Records the requested input assets that didn't load, so initialization continues without them. */
+	void NoteFailedInputAssets(const TArray<FSoftObjectPath>& RequestedPaths);
+
+	/** Starts streaming the device input mappings of the active class of device, if they aren't the ones already loaded. */
+	void LoadDeviceInputMappings();
+	void OnDeviceInputMappingsLoaded(TArray<FSoftObjectPath> RequestedPaths);
+
+	/** Swaps the device input mappings applied for the player for the ones of the active class of device. */
+	void ApplyDeviceInputMappings();
+
+	/** Returns the class of device the player used last, or DefaultDeviceType if they haven't used any yet. */
+	EHardwareDevicePrimaryType GetCurrentDeviceType() const;
+
+	UFUNCTION()
+	void OnInputHardwareDeviceChanged(const FPlatformUserId UserId, const FInputDeviceId DeviceId);
+
 	//~ Begin UActorComponent interface
 	virtual void BeginPlay() override;
 	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
@@ -70,7 +151,47 @@ protected:
 	/** True, when the player input bindings have been applied, will never be true for non-player controlled pawns. */
 	uint8 bReadyToBindInputs : 1;
 
+	/** Time at which the current init state was entered. */
+	double InitStateEnterTime = 0.0;
+
+	/** Input config table shared with every pawn using the same pawn data. */
+	TSharedPtr<const FExperienceInputConfigTable> InputConfigTable;
+
+	/** Input mapping contexts that are still streaming in. */
+	TSharedPtr<struct FStreamableHandle> InputMappingsLoadHandle;
+
+	/** Input assets whose load completed without them resolving, they are skipped rather than requested again. */
+	TSet<FSoftObjectPath> FailedInputAssetPaths;
+
+	/** Class of device the device input mappings are loaded for. */
+	EHardwareDevicePrimaryType ActiveDeviceType = EHardwareDevicePrimaryType::Unspecified;
+
+	/** Keeps the device input mappings of the active class of device loaded. */
+	TSharedPtr<struct FStreamableHandle> DeviceInputMappingsLoadHandle;
+
+	/** Device input mapping contexts currently added for the player. */
+	UPROPERTY(Transient)
+	TArray<TObjectPtr<UInputMappingContext>> AppliedDeviceInputMappings;
+
 	/** List of default input mappings to give to the input component. */
 	UPROPERTY(EditAnywhere, Category = "Hero|Input")
 	TArray<FInputMappingContextAndPriority> DefaultInputMappings;
+
+	/**
+	 * Input mappings only given to the input component while the player is on their class of device.
+	 * Unlike the default input mappings, they aren't streamed with the experience. Only the contexts of the active device are loaded, the others stream in when the player switches devices.
+	 */
+	UPROPERTY(EditAnywhere, Category = "Hero|Input", meta = (TitleProperty = "{DeviceType}"))
+	TArray<FExperienceDeviceInputMapping> DeviceInputMappings;
+
+	/** Class of device assumed until the player has used one. */
+	UPROPERTY(EditAnywhere, Category = "Hero|Input")
+	EHardwareDevicePrimaryType DefaultDeviceType = EHardwareDevicePrimaryType::KeyboardAndMouse;
+
+	/**
+	 * If true, only the input mapping contexts that differ from the ones of the player's previous pawn are added or removed.
+	 * Otherwise every mapping of the player is cleared before the ones of this pawn are added.
+	 */
+	UPROPERTY(EditAnywhere, Category = "Hero|Input")
+	bool bApplyInputMappingsDifferentially = false;
 };
@@ -0,0 +1,60 @@
+// Copyright © 2024 Playton. All Rights Reserved.
+
+#pragma once
+
+#include "GameplayTagContainer.h"
+
+/**
+ * Init state chain compiled from config into integer stages.
+ * Every chain starts with Spawned, Available and Initialized and ends with Ready. Project specific stages (e.g. CosmeticsReady)
+ * may be added between Initialized and Ready. Components check transitions by stage index rather than comparing tags.
+ * Chains are only a handful of states long, so a stage is found by scanning the contiguous array of states instead of hashing the tag.
+ */
+class GAMEPLAYEXPERIENCESRUNTIME_API FExperienceInitStateChain
+{
+public:
+	static constexpr int32 SpawnedStage = 0;
+	static constexpr int32 AvailableStage = 1;
+	static constexpr int32 InitializedStage = 2;
+
+	/** Spawned, Available, Initialized and Ready. */
+	static constexpr int32 MinNumStages = 4;
+
+	/** Compiles the chain from the configured states. Returns false and leaves the chain empty if the states don't make up a valid chain. */
+	bool Compile(TConstArrayView<FGameplayTag> InStates, FString& OutError);
+
+	/** Returns true if the chain has been compiled successfully. */
+	bool IsValid() const { return States.Num() >= MinNumStages; }
+
+	/** Returns the states of the chain, in order. */
+	const TArray<FGameplayTag>& GetStates() const { return States; }
+
+	/** Returns the number of stages of the chain. */
+	int32 Num() const { return States.Num(); }
+
+	/** Returns the last stage of the chain. */
+	int32 GetReadyStage() const { return States.Num() - 1; }
+
+	/** Returns the state of the stage, or an empty tag for stages outside of the chain. */
+	FGameplayTag GetState(int32 Stage) const { return States.IsValidIndex(Stage) ? States[Stage] : FGameplayTag(); }
+
+	/** Returns the stage of the state, or INDEX_NONE if the state isn't part of the chain. */
+	int32 GetStage(FGameplayTag State) const
+	{
+		return States.IndexOfByKey(State);
+	}
+
+	/**
+	 * Returns the stage entered by going from CurrentState to DesiredState, or INDEX_NONE if the transition isn't part of the chain.
+	 * Going from no state to Spawned enters the first stage.
+	 */
+	int32 GetTransitionStage(FGameplayTag CurrentState, FGameplayTag DesiredState) const
+	{
+		const int32 DesiredStage = GetStage(DesiredState);
+		const int32 CurrentStage = CurrentState.IsValid() ? GetStage(CurrentState) : INDEX_NONE;
+		return (DesiredStage != INDEX_NONE && DesiredStage == CurrentStage + 1 && (CurrentStage != INDEX_NONE || !CurrentState.IsValid())) ? DesiredStage : INDEX_NONE;
+	}
+
+private:
+	TArray<FGameplayTag> States;
+};
@@ -0,0 +1,56 @@
+// Copyright © 2024 Playton. All Rights Reserved.
+
+#pragma once
+
+#include "GameplayTagContainer.h"
+
+class AActor;
+class UGameFrameworkComponentManager;
+struct FActorInitStateChangedParams;
+
+/**
+ * Tracks which init state features of a pawn still have to reach a target state before the owning feature can advance.
+ * Replaces re-checking every registered feature on every state change with a count of outstanding prerequisites,
+ * kept up to date from the state changes of the pawn's features, so the owner is only told to advance once, when the last of them resolves.
+ *
+ * State is kept per pawn, the features are discovered from the pawn's own components.
+ */
+class GAMEPLAYEXPERIENCESRUNTIME_API FExperienceInitStateCoordinator
+{
+public:
+	/** Starts tracking the features of the actor that haven't reached the target state yet. */
+	void Initialize(UGameFrameworkComponentManager* Manager, AActor* Actor, FName InOwnerFeature, FGameplayTag InTargetState);
+
+	/** Stops tracking, the owner won't be told to advance anymore. */
+	void Finish();
+
+	/**
+	 * Records a state change of another feature.
+	 * Returns true if the owner should try to advance, i.e. the last outstanding feature just reached the target state.
+	 */
+	bool HandleFeatureStateChanged(UGameFrameworkComponentManager* Manager, const FActorInitStateChangedParams& Params);
+
+	/** Drops outstanding features that are no longer registered. Returns true if nothing is outstanding afterwards. */
+	bool Refresh(UGameFrameworkComponentManager* Manager, AActor* Actor);
+
+	/** Returns true if the coordinator is tracking features. Owners fall back to checking every feature when it isn't. */
+	bool IsTracking() const { return bTracking; }
+
+	/** Returns true if every tracked feature has reached the target state. */
+	bool IsComplete() const { return bTracking && NumPendingFeatures == 0; }
+
+	/** Returns a feature that hasn't reached the target state yet, if any. */
+	FName GetFirstPendingFeature() const;
+
+private:
+	/** Records the state of a feature, updating the number of outstanding features. */
+	void SetFeatureReached(FName FeatureName, bool bReached);
+
+private:
+	/** Whether each known feature has reached the target state. */
+	TMap<FName, bool, TInlineSetAllocator<8>> FeatureReached;
+	int32 NumPendingFeatures = 0;
+	FGameplayTag TargetState;
+	FName OwnerFeature;
+	bool bTracking = false;
+};
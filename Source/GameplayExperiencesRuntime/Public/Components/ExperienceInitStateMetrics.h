@@ -0,0 +1,51 @@
+// Copyright © 2024 Playton. All Rights Reserved.
+
+#pragma once
+
+#include "GameplayTagContainer.h"
+
+class AActor;
+class FOutputDevice;
+
+/**
+ * Aggregates how long pawns spend in each init state, per pawn class, feature and stage, as well as their total time to ready.
+ * Durations are collected into histograms, which can be dumped with Experience.InitState.DumpMetrics.
+ * The latest values are also published to the GameplayExperiences stat group and the CSV profiler.
+ */
+class GAMEPLAYEXPERIENCESRUNTIME_API FExperienceInitStateMetrics
+{
+public:
+	/** Upper bounds of the histogram buckets in milliseconds. The last bucket takes everything above. */
+	static constexpr int32 NumBuckets = 12;
+	static const float BucketBoundsMs[NumBuckets - 1];
+
+	/** Distribution of durations. */
+	struct FHistogram
+	{
+		uint32 Buckets[NumBuckets] = {};
+		uint32 Count = 0;
+		double TotalMs = 0.0;
+		double MaxMs = 0.0;
+
+		void Add(double DurationMs);
+		double GetAverageMs() const { return Count > 0 ? TotalMs / Count : 0.0; }
+
+		/** Returns an approximation of the given percentile (0-1), as the upper bound of the bucket it falls in. */
+		double GetPercentileMs(double Percentile) const;
+	};
+
+	/** Returns true if metrics are being collected. (Experience.InitState.Metrics) */
+	static bool IsEnabled();
+
+	/** Records a feature of the pawn moving from FromState to ToState, having entered FromState at StateEnterTime. */
+	static void RecordStage(const AActor* Pawn, FName FeatureName, FGameplayTag FromState, FGameplayTag ToState, double StateEnterTime);
+
+	/** Records a pawn reaching the end of its init chain, having started initializing at InitStartTime. */
+	static void RecordTimeToReady(const AActor* Pawn, double InitStartTime);
+
+	/** Writes every histogram to the output device. */
+	static void Dump(FOutputDevice& Ar);
+
+	/** Drops everything collected so far. */
+	static void Reset();
+};
@@ -0,0 +1,92 @@
+// Copyright © 2024 Playton. All Rights Reserved.
+
+#pragma once
+
+#include "Containers/Ticker.h"
+#include "GameplayTagContainer.h"
+#include "Trace/Config.h"
+#include "UObject/WeakObjectPtrTemplates.h"
+
+#if !defined(EXPERIENCE_INITSTATE_TRACE_ENABLED)
+#define EXPERIENCE_INITSTATE_TRACE_ENABLED (UE_TRACE_ENABLED && !UE_BUILD_SHIPPING)
+#endif
+
+#if EXPERIENCE_INITSTATE_TRACE_ENABLED
+#include "Trace/Trace.h"
+#endif
+
+class AActor;
+
+/** Why an init state transition happened or was refused. Traced as a single byte. */
+enum class EExperienceInitStateReason : uint8
+{
+	Transitioned,
+	InvalidPawn,
+	MissingPawnData,
+	MissingController,
+	MissingPlayerState,
+	WaitingForFeatures,
+	InvalidTransition,
+};
+
+#if EXPERIENCE_INITSTATE_TRACE_ENABLED
+
+UE_TRACE_CHANNEL_EXTERN(ExperienceInitStateChannel, GAMEPLAYEXPERIENCESRUNTIME_API)
+
+/**
+ * Writes init state transitions to the ExperienceInitState trace channel, decoded in Unreal Insights by the GameplayExperiencesInsights module.
+ * Events only carry ids and a reason code, names are declared once per unique name. Nothing is formatted while the channel is off.
+ */
+struct GAMEPLAYEXPERIENCESRUNTIME_API FExperienceInitStateTrace
+{
+	static void OutputTransition(const AActor* Pawn, FName FeatureName, FGameplayTag FromState, FGameplayTag ToState, EExperienceInitStateReason Reason);
+};
+
+#define TRACE_EXPERIENCE_INIT_STATE(Pawn, FeatureName, FromState, ToState, Reason) \
+	if (UE_TRACE_CHANNELEXPR_IS_ENABLED(ExperienceInitStateChannel)) \
+	{ \
+		FExperienceInitStateTrace::OutputTransition(Pawn, FeatureName, FromState, ToState, Reason); \
+	}
+
+#else
+
+#define TRACE_EXPERIENCE_INIT_STATE(Pawn, FeatureName, FromState, ToState, Reason)
+
+#endif
+
+/** Returns the name of the reason, as shown in logs and Insights. */
+GAMEPLAYEXPERIENCESRUNTIME_API const TCHAR* LexToString(EExperienceInitStateReason Reason);
+
+/**
+ * Tracks whether a single pawn is stuck going through its init states. Owned by the pawn extension component of the pawn.
+ * Pawns waiting longer than Experience.InitState.StuckThreshold count as stuck until they initialize or end play,
+ * and a summary of every stuck pawn is logged at most every Experience.InitState.StuckSummaryInterval seconds.
+ * The check runs from a ticker while the pawn is tracked, a stuck pawn usually gets no further init state events to report it from.
+ */
+struct GAMEPLAYEXPERIENCESRUNTIME_API FExperienceInitStateStuckTracker
+{
+public:
+	UE_NONCOPYABLE(FExperienceInitStateStuckTracker);
+
+	FExperienceInitStateStuckTracker() = default;
+	~FExperienceInitStateStuckTracker() { End(); }
+
+	/** Starts tracking a pawn that begins going through its init states. */
+	void Begin(const AActor* InPawn);
+
+	/** Records what the pawn is waiting on, reported in the summary once it counts as stuck. */
+	void NoteWaiting(FName InWaitingOn, EExperienceInitStateReason InReason);
+
+	/** Stops tracking the pawn, once it has initialized or goes away. */
+	void End();
+
+private:
+	bool Tick(float DeltaTime);
+
+	TWeakObjectPtr<const AActor> Pawn;
+	FName WaitingOn;
+	EExperienceInitStateReason Reason = EExperienceInitStateReason::Transitioned;
+	double StartTime = 0.0;
+	FTSTicker::FDelegateHandle TickerHandle;
+	bool bStuck = false;
+};
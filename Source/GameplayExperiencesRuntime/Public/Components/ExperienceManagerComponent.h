@@ -4,10 +4,14 @@
 
 #include "CoreMinimal.h"
 #include "LoadingProcessInterface.h"
+#include "Actions/GameFeatureAction_AddInputConfig.h"
 #include "Components/GameStateComponent.h"
 #include "ExperienceManagerComponent.generated.h"
 
+class FExperienceInputConfigTable;
 class UExperienceDefinition;
+class UExperiencePawnData;
+struct FStreamableHandle;
 
 namespace UE::GameFeatures
 {
@@ -21,6 +25,7 @@ enum class EExperienceLoadState
 	Unloaded,
 	Loading,
 	LoadingGameFeatures,
+	Preloading,
 	LoadingChaosTestingDelay,
 	ExecutingActions,
 	Loaded,
@@ -52,15 +57,39 @@ public:
 	/** Returns true if the experience has been fully loaded. */
 	bool IsExperienceLoaded() const;
 
+	/** Returns true if an experience has been assigned, whether or not it has finished loading. */
+	bool HasExperienceAssigned() const { return CurrentExperience != nullptr; }
+
+	/** Returns true if the world still has streaming levels that should be loaded or made visible. */
+	static bool IsLevelStreamingPending(const UWorld* World);
+
 	/** Returns the currently loaded experience. */
 	const UExperienceDefinition* GetLoadedExperience() const;
 
 	/** Returns the current experience if it has been loaded, otherwise asserts. */
 	const UExperienceDefinition* GetLoadedExperience_Checked() const;
 
+	/**
+	 * Returns the input config of the pawn data merged with the input configs contributed by the experience and its action sets.
+	 * Tables are built when the experience loads, or on first use for pawn data the experience doesn't reference.
+	 * Null until the experience and the input config of the pawn data have loaded.
+	 */
+	TSharedPtr<const FExperienceInputConfigTable> GetInputConfigTable(const UExperiencePawnData* PawnData) const;
+
 	/** Tries to set the current experience. */
 	void SetCurrentExperience(FPrimaryAssetId ExperienceId);
 
+	/**
+	 * Deactivates and activates again every action of the loaded experience implementing IExperienceResettableAction.
+	 * Used to reset the match in place, without unloading the experience.
+	 * Actions that deactivate asynchronously are waited for before any action is activated again.
+	 * The delegate is called once every action has been activated again, right away if nothing had to be waited for.
+	 */
+	void ResetExperienceActions(FSimpleDelegate OnResetComplete);
+
+	/** Returns true while ResetExperienceActions waits for actions to finish deactivating. */
+	bool IsResettingExperienceActions() const { return ResettingActions.Num() > 0; }
+
 	/**
 	 * Ensures the delegate is called once the experience has been loaded, before others are called.
 	 * However, if the experience has already loaded, the delegate is called immediately.
@@ -89,9 +118,23 @@ protected:
 	
 	void OnGameFeaturePluginLoadComplete(const UE::GameFeatures::FResult& Result);
 
+	/**
+	 * Streams the ability, gameplay effect and gameplay cue classes the experience uses, so their first use doesn't hitch mid-match.
+	 * Classes are gathered from the actions and pawn data of the experience, then from what the loaded abilities and effects reference.
+	 */
+	void StartExperiencePreload();
+	void OnPreloadClassesLoaded();
+	void OnPreloadCompleted();
+
+	/** Gathers the input configs contributed by the actions of the experience and builds the input config tables of its pawn data. */
+	void BuildInputConfigTables();
+
 	void OnActionDeactivationCompleted();
 	void OnAllActionsDeactivated();
 
+	void OnResetActionDeactivationCompleted();
+	void ActivateResetActions();
+
 private:
 	/** Replicated experience */
 	UPROPERTY(ReplicatedUsing = OnRep_CurrentExperience)
@@ -100,11 +143,44 @@ private:
 	EExperienceLoadState LoadState = EExperienceLoadState::Unloaded;
 
 	int32 NumGameFeaturePluginsLoading = 0;
+
+	/** Set once the match has begun with no level streaming pending, later streaming no longer shows the loading screen. */
+	mutable bool bInitialLevelStreamingDone = false;
 	TArray<FString> GameFeaturePluginURLs;
 
+	/** If true, the gameplay classes used by the experience are loaded before it is considered loaded. */
+	UPROPERTY(Config)
+	bool bPreloadGameplayClasses = true;
+
+	/** If true, the default objects of the preloaded classes are constructed as part of the load as well. */
+	UPROPERTY(Config)
+	bool bConstructPreloadedDefaultObjects = true;
+
+	/** Classes preloaded for the experience, kept loaded for as long as it is active. */
+	UPROPERTY(Transient)
+	TArray<TObjectPtr<UClass>> PreloadedClasses;
+
+	TSharedPtr<FStreamableHandle> PreloadHandle;
+	double PreloadStartTime = 0.0;
+
+	/** Input configs contributed by the actions of the experience. */
+	TArray<FExperienceInputConfigEntry> InputConfigContributions;
+
+	/** Input config tables of the pawn data used with the experience. */
+	mutable TMap<TObjectKey<UExperiencePawnData>, TSharedRef<const FExperienceInputConfigTable>> InputConfigTables;
+
 	int32 NumObservedPausers = 0;
 	int32 NumExpectedPausers = 0;
 
+	/** Actions being reset by ResetExperienceActions, waiting to be activated again. */
+	UPROPERTY(Transient)
+	TArray<TObjectPtr<UGameFeatureAction>> ResettingActions;
+
+	int32 NumObservedResetPausers = 0;
+	int32 NumExpectedResetPausers = 0;
+
+	FSimpleDelegate OnResetActionsComplete;
+
 	FOnExperienceLoaed OnExperienceLoaded_HighPriority;
 	FOnExperienceLoaed OnExperienceLoaded;
 	FOnExperienceLoaed OnExperienceLoaded_LowPriority;
@@ -4,6 +4,8 @@
 
 #include "CoreMinimal.h"
 #include "ExperiencePawnData.h"
+#include "Components/ExperienceInitStateCoordinator.h"
+#include "Components/ExperienceInitStateTrace.h"
 #include "Components/GameFrameworkInitStateInterface.h"
 #include "Components/PawnComponent.h"
 
@@ -51,8 +53,19 @@ public:
 	/** Should be called by the owning pawn to become the avatar of the ability system. */
 	virtual void InitializeAbilitySystem(UAbilitySystemComponent* InASC, AActor* InOwnerActor);
 
-	/** Should be called by the owning pawn to remove itself as the avatar of the ability system. */
-	virtual void UninitializeAbilitySystem();
+	/**
+	 * Should be called by the owning pawn to remove itself as the avatar of the ability system.
+	 * Pass bHandOffToNextPawn when the player's next pawn is about to take over, on death before a respawn or when the player possesses another pawn.
+	 * The ability system is then left warm for it if the player state uses warm handoffs, otherwise it is always torn down.
+	 */
+	virtual void UninitializeAbilitySystem(bool bHandOffToNextPawn = false);
+
+	/**
+	 * Puts the ability system back in the state a freshly spawned pawn would find it in, e.g. when the pawn is reused for a new round.
+	 * Removes the active effects, cooldowns included, and initializes the ability system again, which reapplies the attribute defaults.
+	 * Returns false if the pawn isn't the avatar of its ability system.
+	 */
+	virtual bool ResetAbilitySystem();
 
 	/** Should be called by the owning pawn when the pawn's controller changes. */
 	virtual void HandleControllerChanged();
@@ -90,6 +103,12 @@ public:
 	void SetPawnData(const UExperiencePawnData* InPawnData);
 
 protected:
+	/**
+	 * Returns true if the feature can enter the given stage of the init state chain, coming from the previous one.
+	 * Override to add conditions for project specific stages, which can otherwise be entered right away.
+	 */
+	virtual bool CanEnterInitStage(UGameFrameworkComponentManager* Manager, int32 Stage) const;
+
 	/** OnRep function for PawnData. */
 	UFUNCTION()
 	virtual void OnRep_PawnData();
@@ -109,6 +128,18 @@ protected:
 	UPROPERTY(Transient)
 	TObjectPtr<UAbilitySystemComponent> AbilitySystem;
 
+	/** Features of the pawn that still have to become available before it can be initialized. */
+	FExperienceInitStateCoordinator InitStateCoordinator;
+
+	/** Time at which the pawn started going through its init states. */
+	double InitStartTime = 0.0;
+
+	/** Time at which the current init state was entered. */
+	double InitStateEnterTime = 0.0;
+
+	/** Counts the pawn towards the stuck pawn summaries while it takes too long to initialize. Noted from the const transition checks. */
+	mutable FExperienceInitStateStuckTracker StuckTracker;
+
 	/** List of group names to use when initializing default attribute set values */
 	UPROPERTY(EditAnywhere, Category = Pawn)
 	TArray<FName> DefaultAttributeSetGroupNames;
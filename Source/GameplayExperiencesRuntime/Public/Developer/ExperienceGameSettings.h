@@ -9,6 +9,8 @@
 
 class UExperiencePawnData;
 class UExperienceGameData;
+class UExperienceMatchAssignmentProvider;
+
 /**
  * Developer settings for the gameplay experiences framework.
  */
@@ -52,8 +54,23 @@ public:
 	UPROPERTY(Config, EditDefaultsOnly, Category = "Defaults", meta = (ConfigRestartRequired = true))
 	TSoftObjectPtr<UExperiencePawnData> DefaultPawnData;
 
-protected:
-	/** The initialization state chain to use for the modular gameplay. */
-	UPROPERTY(Config, EditDefaultsOnly, Category = ModularGameplay, meta = (ConfigRestartRequired = true, Categories = "InitState", DisplayName = "State Chain (Order Matters!!!)", EditFixedOrder), EditFixedSize)
-	TArray<FGameplayTag> StateChain;
+	/** Provider dedicated servers use to receive their match assignment. None disables waiting for an assignment. */
+	UPROPERTY(Config, EditDefaultsOnly, Category = "Matchmaking", meta = (ConfigRestartRequired = true))
+	TSoftClassPtr<UExperienceMatchAssignmentProvider> MatchAssignmentProviderClass;
+
+	/** If true, the assigned experience starts loading as soon as the assignment arrives, even before the map has been loaded. */
+	UPROPERTY(Config, EditDefaultsOnly, Category = "Matchmaking")
+	bool bPrefetchAssignedExperience = true;
+
+	/** If true, dedicated servers preload experiences right after the asset manager has been initialized. Can also be enabled with -ExperienceWarmStart. */
+	UPROPERTY(Config, EditDefaultsOnly, Category = "Warm Start", meta = (ConfigRestartRequired = true))
+	bool bWarmStartDedicatedServer = false;
+
+	/** Experiences to preload during warm start. Empty preloads the default experience. */
+	UPROPERTY(Config, EditDefaultsOnly, Category = "Warm Start", meta = (AllowedTypes = "ExperienceDefinition", ConfigRestartRequired = true))
+	TArray<FPrimaryAssetId> WarmStartExperiences;
+
+	/** If true, the global game data is loaded as part of warm start. */
+	UPROPERTY(Config, EditDefaultsOnly, Category = "Warm Start", meta = (ConfigRestartRequired = true))
+	bool bWarmStartGameData = true;
 };
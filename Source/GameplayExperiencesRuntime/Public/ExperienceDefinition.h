@@ -8,12 +8,65 @@
 
 #include "ExperienceDefinition.generated.h"
 
+class AAIController;
 class UExperiencePawnData;
 class UGameFeatureActionSet;
 class UGameFeatureAction;
 struct FPrimaryAssetTypeInfo;
 struct FAssetData;
 
+/**
+ * Rules used by the UExperiencePlayerStartSubsystem to index and pick player starts for an experience.
+ */
+USTRUCT(BlueprintType)
+struct FExperiencePlayerStartSettings
+{
+	GENERATED_BODY()
+
+public:
+	/** If true, player starts are picked from an occupancy-aware index instead of the linear search of the game mode base class. */
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Player Starts")
+	bool bUseIndexedPlayerStarts = true;
+
+	/** Only player starts with one of these PlayerStartTags are used. Empty means every player start is used. */
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Player Starts")
+	TArray<FName> AllowedPlayerStartTags;
+
+	/** Maps a team id to the PlayerStartTag of the starts reserved for that team. Starts without a team can be used by anyone. */
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Player Starts")
+	TMap<uint8, FName> TeamPlayerStartTags;
+
+	/** Time in seconds a player start stays blocked after someone spawned on it. */
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Player Starts", meta = (ClampMin = 0, Units = "s"))
+	float ClaimCooldown = 2.f;
+
+	/** Player starts closer than this to a claimed start are blocked as well, as a pawn spawned there would overlap. */
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Player Starts", meta = (ClampMin = 0, Units = "cm"))
+	float OccupancyRadius = 100.f;
+};
+
+/**
+ * Bots the game mode fills the match with once the experience has loaded.
+ */
+USTRUCT(BlueprintType)
+struct FExperienceBotFillSettings
+{
+	GENERATED_BODY()
+
+public:
+	/** Number of bots to spawn. Can be overridden with -NumBots=<N> on the command line. */
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Bots", meta = (ClampMin = 0))
+	int32 NumBots = 0;
+
+	/** Controller class used for the bots. Falls back to AAIController. */
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Bots")
+	TSubclassOf<AAIController> BotControllerClass;
+
+	/** Pawn data shared by every bot. Falls back to the default pawn data of the experience. Streamed with the bundles of the experience. */
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Bots", meta = (AssetBundles = "Client,Server"))
+	TSoftObjectPtr<UExperiencePawnData> BotPawnData;
+};
+
 /**
  * Defines a gameplay experience, a collection of code and content that adds a separable discrete feature to the game.
  */
@@ -53,7 +106,15 @@ public:
 	UPROPERTY(EditDefaultsOnly, Category = "Actions")
 	TArray<TObjectPtr<UGameFeatureActionSet>> FeatureActionSets;
 
-	/** The default pawn data used by this experience */
+	/** The default pawn data used by this experience. Streamed with the bundles of the experience, along with its pawn class and the rest of the pawn graph. */
+	UPROPERTY(EditDefaultsOnly, Category = "Gameplay", meta = (AssetBundles = "Client,Server"))
+	TSoftObjectPtr<UExperiencePawnData> DefaultPawnData;
+
+	/** Rules for picking the player starts pawns are spawned at */
+	UPROPERTY(EditDefaultsOnly, Category = "Gameplay")
+	FExperiencePlayerStartSettings PlayerStartSettings;
+
+	/** Bots to fill the match with */
 	UPROPERTY(EditDefaultsOnly, Category = "Gameplay")
-	TObjectPtr<const UExperiencePawnData> DefaultPawnData;
+	FExperienceBotFillSettings BotFillSettings;
 };
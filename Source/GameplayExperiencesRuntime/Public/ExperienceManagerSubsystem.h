@@ -3,13 +3,26 @@
 #pragma once
 
 #include "GameplayTagContainer.h"
+#include "Components/ExperienceInitStateChain.h"
+#include "Matchmaking/ExperienceMatchAssignmentProvider.h"
 #include "Subsystems/EngineSubsystem.h"
 
 #include "ExperienceManagerSubsystem.generated.h"
 
+class UWorld;
+struct FStreamableHandle;
+
+namespace UE::GameFeatures
+{
+	struct FResult;
+}
+
+DECLARE_MULTICAST_DELEGATE_OneParam(FOnExperiencePrefetched, const FPrimaryAssetId& /*ExperienceId*/);
+
 /**
  * Manager for experiences
- * Primarily for arbitration between multiple PIE sessions
+ * Arbitrates between multiple worlds sharing the process, e.g. PIE sessions or several matches hosted by one dedicated server.
+ * Game feature plugin activation is refcounted per requester and experience bundle state per world, so one world ending doesn't pull them from under the others.
  */
 UCLASS(Config = Game)
 class GAMEPLAYEXPERIENCESRUNTIME_API UExperienceManagerSubsystem : public UEngineSubsystem
@@ -19,27 +32,194 @@ class GAMEPLAYEXPERIENCESRUNTIME_API UExperienceManagerSubsystem : public UEngin
 public:
 	UExperienceManagerSubsystem();
 	static UExperienceManagerSubsystem* Get();
-	
+
+	//~ Begin USubsystem Interface
+	virtual void Initialize(FSubsystemCollectionBase& Collection) override;
+	virtual void Deinitialize() override;
+	//~ End USubsystem Interface
+
+	/** Returns true if a match assignment provider is active and the world hasn't claimed an assignment yet. */
+	bool IsExpectingMatchAssignment(const UWorld* World) const;
+
+	/**
+	 * Claims a match assignment for the world.
+	 * A world keeps the assignment it claimed until ReleaseMatchAssignment, otherwise it is handed the oldest assignment nobody claimed yet.
+	 */
+	bool ClaimMatchAssignment(const UWorld* World, FExperienceMatchAssignment& OutAssignment);
+
+	/**
+	 * Drops the assignment claimed by the world, the next match it hosts waits for a new one.
+	 * The prefetch started for the assignment is released as well, unless another assignment uses the same experience.
+	 */
+	void ReleaseMatchAssignment(const UWorld* World);
+
+	/**
+	 * Ensures the delegate is called once an unclaimed match assignment is available.
+	 * If one is available already, the delegate is called immediately. Assignments are offered to waiting delegates in registration order, until one claims it.
+	 */
+	FDelegateHandle CallOrRegister_OnMatchAssignmentReceived(FOnExperienceMatchAssignmentReceived::FDelegate&& Delegate);
+
+	/** Removes a delegate registered with CallOrRegister_OnMatchAssignmentReceived. */
+	void Unregister_OnMatchAssignmentReceived(FDelegateHandle Handle);
+
+	/**
+	 * Starts streaming the experience definition, its bundles and action sets and loads its game feature plugins without activating them.
+	 * The loaded state is kept so the experience can be activated later without waiting on it.
+	 * Experiences prefetched this way stay resident, unlike the ones prefetched for a match assignment.
+	 */
+	void PrefetchExperience(const FPrimaryAssetId& ExperienceId);
+
+	/** Returns true if the experience has been prefetched and everything it needs is loaded. */
+	bool IsExperiencePrefetched(const FPrimaryAssetId& ExperienceId) const;
+
+	/** Delegate called when a prefetch started with PrefetchExperience has completed. */
+	FOnExperiencePrefetched OnExperiencePrefetched;
+
+	/** Returns true once warm start has finished, or if this process didn't warm start. */
+	bool IsWarmStartComplete() const { return !bWarmStartPending; }
+
+	/**
+	 * Ensures the delegate is called once warm start has finished.
+	 * If it already has (or never ran), the delegate is called immediately.
+	 */
+	void CallOrRegister_OnWarmStartComplete(FSimpleMulticastDelegate::FDelegate&& Delegate);
+
 #if WITH_EDITOR
 	void OnPlayInEditorBegun();
-
-	static void NotifyOfPluginActivation(const FString PluginURL);
-	static bool RequestToDeactivatePlugin(const FString PluginURl);
-#else
-	static void NotifyOfPluginActivation(const FString PluginURL) {}
-	static bool RequestToDeactivatePlugin(const FString PluginURl) { return true; }
 #endif
 
-	FGameplayTag GetTag_Spawned() const { return StateChain[0]; }
-	FGameplayTag GetTag_Available() const { return StateChain[1]; }
-	FGameplayTag GetTag_Initialized() const { return StateChain[2]; }
-	FGameplayTag GetTag_Ready() const { return StateChain[3]; }
+	/** Records a request from the given requester (e.g. the experience manager component of a world) to keep the plugin active. */
+	static void NotifyOfPluginActivation(const FString PluginURL, const UObject* Requester = nullptr);
+
+	/** Drops one request of the given requester. Returns true if nobody requests the plugin anymore and it should be deactivated. */
+	static bool RequestToDeactivatePlugin(const FString PluginURl, const UObject* Requester = nullptr);
+
+	/** Drops every request of the given requester. Returns true if nobody requests the plugin anymore and it should be deactivated. */
+	static bool ReleasePluginRequests(const FString& PluginURL, const UObject* Requester);
+
+	/**
+	 * Adds the bundle state the experience of a world needs. Bundles are refcounted across every world of the process.
+	 * Releases whatever the world acquired before. Returns the handle to wait on, if anything still has to load.
+	 */
+	TSharedPtr<FStreamableHandle> AcquireExperienceBundles(const UWorld* World, const FPrimaryAssetId& ExperienceId, const TArray<FPrimaryAssetId>& AssetIds, const TArray<FName>& Bundles);
+
+	/** Releases the bundle state acquired for a world, removing the bundles no other world needs anymore. */
+	void ReleaseExperienceBundles(const UWorld* World);
+
+	/** Returns the number of worlds that currently host an experience. */
+	int32 GetNumHostedExperiences() const { return WorldExperiences.Num(); }
+
+	/** Returns the init state chain compiled from StateChain. */
+	const FExperienceInitStateChain& GetInitStateChain() const { return InitStateChain; }
+
+	FGameplayTag GetTag_Spawned() const { return InitStateChain.GetState(FExperienceInitStateChain::SpawnedStage); }
+	FGameplayTag GetTag_Available() const { return InitStateChain.GetState(FExperienceInitStateChain::AvailableStage); }
+	FGameplayTag GetTag_Initialized() const { return InitStateChain.GetState(FExperienceInitStateChain::InitializedStage); }
+	FGameplayTag GetTag_Ready() const { return InitStateChain.GetState(InitStateChain.GetReadyStage()); }
 
 public:
+	/** The init states pawn features go through, in order. See FExperienceInitStateChain. */
 	UPROPERTY(Config)
 	TArray<FGameplayTag> StateChain;
 
+protected:
+	void OnMatchAssignmentReceived(const FExperienceMatchAssignment& Assignment);
+
+	/** Offers the pending assignments to the waiting delegates. */
+	void DispatchMatchAssignments();
+	void OnPrefetchedExperienceLoaded(FPrimaryAssetId ExperienceId);
+	void OnPrefetchPluginLoaded(const UE::GameFeatures::FResult& Result, FPrimaryAssetId ExperienceId);
+	void OnPrefetchOperationCompleted(FPrimaryAssetId ExperienceId);
+	void CompletePrefetch(FPrimaryAssetId ExperienceId);
+
+	/** Starts the prefetch of the experience, without deciding whether it stays resident. */
+	void StartPrefetch(FPrimaryAssetId ExperienceId);
+
+	/** Releases the prefetch of the experience, dropping the bundle state no world has acquired. */
+	void ReleasePrefetch(const FPrimaryAssetId& ExperienceId);
+
+	/** Returns true if this process should preload experiences at boot. */
+	static bool ShouldWarmStart();
+
+	void BeginWarmStart();
+	void OnWarmStartExperiencePrefetched(const FPrimaryAssetId& ExperienceId);
+	void CompleteWarmStart();
+
+	/** Returns the bundles to load for experiences in this process. */
+	static TArray<FName> GetPrefetchBundles();
+
+public:
+	/**
+	 * Collects the pawn data the experience spawns with. Pawn data known to the asset manager is returned as primary asset, so its bundles can be loaded.
+	 * Pawn data that isn't is a configuration error, it is returned as plain path so it still gets loaded, but without its bundles.
+	 */
+	static void GetExperiencePawnData(const UExperienceDefinition* Experience, TArray<FPrimaryAssetId>& OutPrimaryAssetIds, TArray<FSoftObjectPath>& OutUnregisteredPaths);
+
 private:
-	/** Map of requests to active count for a given game feature plugin. (allow first in, last out management during PIE) */
-	TMap<FString, int32> GameFeaturePluginRequestCountMap;
+	/** Compiled from StateChain on initialization. */
+	FExperienceInitStateChain InitStateChain;
+
+	/** Cached so the init state checks of every pawn don't have to look the subsystem up through the engine. */
+	static UExperienceManagerSubsystem* Instance;
+
+	/** Active provider for matchmaking assignments. */
+	UPROPERTY(Transient)
+	TObjectPtr<UExperienceMatchAssignmentProvider> MatchAssignmentProvider;
+
+	/** Assignments received from the provider that no world has claimed yet, oldest first. */
+	TArray<FExperienceMatchAssignment> PendingMatchAssignments;
+
+	/** Assignment claimed by each world, until the world ends. */
+	TMap<TObjectKey<UWorld>, FExperienceMatchAssignment> ClaimedMatchAssignments;
+
+	/** Delegates waiting for an assignment, in registration order. */
+	TArray<TPair<FDelegateHandle, FOnExperienceMatchAssignmentReceived::FDelegate>> MatchAssignmentWaiters;
+
+	/** State of an experience prefetch. The handles keep the prefetched assets loaded. */
+	struct FExperiencePrefetch
+	{
+		TSharedPtr<FStreamableHandle> ExperienceHandle;
+		TSharedPtr<FStreamableHandle> BundleAssetHandle;
+		TSharedPtr<FStreamableHandle> RawAssetHandle;
+
+		/** Action sets and pawn data of the experience, which carry their own bundles. */
+		TArray<FPrimaryAssetId> BundleAssetIds;
+		double StartTime = 0.0;
+		int32 NumPendingOperations = 0;
+		bool bComplete = false;
+	};
+
+	TMap<FPrimaryAssetId, FExperiencePrefetch> Prefetches;
+
+	/** Experiences prefetched only because a match assignment asked for them, released along with the assignment. */
+	TSet<FPrimaryAssetId> MatchAssignmentPrefetches;
+
+	/** Experiences warm start is still waiting on. */
+	TSet<FPrimaryAssetId> PendingWarmStartExperiences;
+
+	FSimpleMulticastDelegate OnWarmStartComplete;
+	double WarmStartBeginTime = 0.0;
+	bool bWarmStartPending = false;
+
+	/** Requests to keep a game feature plugin active, per requester. (allow first in, last out management across worlds and requesters) */
+	struct FPluginRequests
+	{
+		TMap<FObjectKey, int32> CountPerRequester;
+		int32 TotalCount = 0;
+	};
+
+	TMap<FString, FPluginRequests> GameFeaturePluginRequests;
+
+	/** Bundle state acquired for the experience of a world. */
+	struct FWorldExperience
+	{
+		FPrimaryAssetId ExperienceId;
+		TArray<FPrimaryAssetId> AssetIds;
+		TArray<FName> Bundles;
+	};
+
+	TMap<TObjectKey<UWorld>, FWorldExperience> WorldExperiences;
+
+	/** Number of worlds needing each bundle of each asset. */
+	TMap<TPair<FPrimaryAssetId, FName>, int32> BundleRefCounts;
 };
@@ -21,15 +21,15 @@ public:
 	UExperiencePawnData(const FObjectInitializer& ObjectInitializer = FObjectInitializer::Get());
 
 public:
-	/** Class to instantiate for this pawn. */
-	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Pawn")
-	TSubclassOf<APawn> PawnClass;
+	/** Class to instantiate for this pawn. Streamed with the bundles of the pawn data, which the experience loads along with its own, so loading the pawn data alone doesn't pull in the pawn blueprint. */
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Pawn", meta = (AssetBundles = "Client,Server"))
+	TSoftClassPtr<APawn> PawnClass;
 
-	/** Input config to use for player-controlled pawns. */
-	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Pawn")
-	TObjectPtr<UInputConfig> InputConfig;
+	/** Input config to use for player-controlled pawns. Only loaded with the client bundle, dedicated servers never load it or the input actions it references. */
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Pawn", meta = (AssetBundles = "Client"))
+	TSoftObjectPtr<UInputConfig> InputConfig;
 
-	/** The gameplay tag relationship mapping to use for this pawn. */
-	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Abilities")
-	TObjectPtr<UModularAbilityTagRelationshipMapping> TagRelationshipMapping;
+	/** The gameplay tag relationship mapping to use for this pawn. Streamed with the bundles of the pawn data. */
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Abilities", meta = (AssetBundles = "Client,Server"))
+	TSoftObjectPtr<UModularAbilityTagRelationshipMapping> TagRelationshipMapping;
 };
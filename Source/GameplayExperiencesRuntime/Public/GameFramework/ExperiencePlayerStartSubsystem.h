@@ -0,0 +1,132 @@
+// Copyright © 2024 Playton. All Rights Reserved.
+
+#pragma once
+
+#include "ExperienceDefinition.h"
+#include "Subsystems/WorldSubsystem.h"
+
+#include "ExperiencePlayerStartSubsystem.generated.h"
+
+class AController;
+class APawn;
+class APlayerStart;
+class ULevel;
+
+/**
+ * World subsystem that indexes the player starts of the world once the experience has loaded.
+ * Tracks claims and cooldowns incrementally, so picking a free start doesn't need to walk every start or run collision checks.
+ */
+UCLASS()
+class GAMEPLAYEXPERIENCESRUNTIME_API UExperiencePlayerStartSubsystem : public UWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	UExperiencePlayerStartSubsystem();
+
+	/** Team id used for controllers and starts that don't belong to any team. */
+	static constexpr uint8 NoTeamId = 255;
+
+	//~ Begin UWorldSubsystem Interface
+	virtual void Initialize(FSubsystemCollectionBase& Collection) override;
+	virtual void Deinitialize() override;
+	//~ End UWorldSubsystem Interface
+
+	/** (Re)builds the index from all player starts currently in the world. */
+	void BuildIndex(const FExperiencePlayerStartSettings& InSettings);
+
+	/** Drops the index and all claims. */
+	void ResetIndex();
+
+	/** Returns true if the index has been built and can be queried. */
+	bool IsIndexBuilt() const { return bIndexBuilt; }
+
+	/**
+	 * Picks a free player start usable by the given team and claims it.
+	 * Returns nullptr if every matching start is blocked.
+	 */
+	APlayerStart* ClaimPlayerStart(const AController* Controller, uint8 TeamId);
+
+	/** Releases the start last claimed by the controller right away, e.g. when no pawn could be spawned there. */
+	void ReleaseClaim(const AController* Controller);
+
+	/** Records the pawn spawned at the start last claimed by the controller, keeping the start blocked while the pawn stands on it. */
+	void SetClaimOccupant(const AController* Controller, const APawn* Pawn);
+
+	/** Releases every claim, keeping the index intact. */
+	void ReleaseAllClaims();
+
+	/** Returns the number of indexed player starts. */
+	int32 GetNumIndexedPlayerStarts() const { return EntryLookup.Num(); }
+
+protected:
+	//~ Begin UWorldSubsystem Interface
+	virtual bool DoesSupportWorldType(const EWorldType::Type WorldType) const override;
+	//~ End UWorldSubsystem Interface
+
+	void OnLevelAddedToWorld(ULevel* Level, UWorld* World);
+	void OnLevelRemovedFromWorld(ULevel* Level, UWorld* World);
+
+	void AddPlayerStart(APlayerStart* PlayerStart);
+	void RemovePlayerStart(APlayerStart* PlayerStart);
+	void RemoveEntry(int32 EntryIndex);
+
+	uint8 GetTeamIdForPlayerStart(const APlayerStart* PlayerStart) const;
+	int32 FindOrAddBucket(uint8 TeamId);
+
+	void ProcessExpiredClaims(double Now);
+	void BlockEntry(int32 EntryIndex);
+	void UnblockEntry(int32 EntryIndex);
+	void AddToFreeList(int32 EntryIndex);
+	void RemoveFromFreeList(int32 EntryIndex);
+
+private:
+	/** An indexed player start. */
+	struct FEntry
+	{
+		TWeakObjectPtr<APlayerStart> PlayerStart;
+		TWeakObjectPtr<const APawn> Occupant;
+		TArray<int32> Neighbours;
+		FVector Location = FVector::ZeroVector;
+		int32 BucketIndex = INDEX_NONE;
+		int32 FreeSlot = INDEX_NONE;
+		int32 NumBlockers = 0;
+		bool bRemoved = false;
+	};
+
+	/** Free starts for one team. */
+	struct FBucket
+	{
+		TArray<int32> FreeEntries;
+		uint8 TeamId = NoTeamId;
+	};
+
+	/** A claimed start waiting for its cooldown to expire. Claims are queued in release order. */
+	struct FClaim
+	{
+		double ReleaseTime = 0.0;
+		int32 EntryIndex = INDEX_NONE;
+	};
+
+	FExperiencePlayerStartSettings Settings;
+
+	TArray<FEntry> Entries;
+	TArray<FBucket> Buckets;
+	TMap<uint8, int32> BucketLookup;
+	TMap<TObjectKey<APlayerStart>, int32> EntryLookup;
+
+	/** Uniform grid of entries, only used to find neighbours when starts are added. */
+	TMap<FIntVector, TArray<int32>> Grid;
+	float GridCellSize = 100.f;
+
+	TArray<FClaim> Claims;
+	int32 ClaimsHead = 0;
+
+	/** Last start claimed by each controller, so the spawned pawn can be recorded as occupant. */
+	TMap<TObjectKey<AController>, int32> LastClaimByController;
+
+	FDelegateHandle LevelAddedHandle;
+	FDelegateHandle LevelRemovedHandle;
+
+	bool bIndexBuilt = false;
+};
@@ -33,6 +33,24 @@ public:
 	/** Sets the pawn data for this player state. */
 	void SetPawnData(const UExperiencePawnData* InPawnData);
 
+	/** Clears the pawn data, so a new one can be set. (e.g. when the match is reset) */
+	void ClearPawnData();
+
+	/** Returns true if the ability system owned by this player state is handed from one pawn to the next without being torn down in between. */
+	bool UsesWarmAbilitySystemHandoff() const { return bWarmAbilitySystemHandoff; }
+
+	/** Records that the pawn let go of the ability system, leaving its avatar, gameplay cues and tag relationship mapping in place for the next pawn. */
+	void BeginAbilitySystemHandoff(const APawn* FromPawn, const UExperiencePawnData* FromPawnData);
+
+	/** Returns true if a handoff from the avatar is pending. */
+	bool IsAbilitySystemHandoffPendingFrom(const AActor* FromAvatar) const;
+
+	/** Completes the pending handoff from the avatar. Returns false if there is none, otherwise gives the pawn data the avatar used. */
+	bool ConsumeAbilitySystemHandoff(const AActor* FromAvatar, const UExperiencePawnData*& OutFromPawnData);
+
+	/** Forgets the pawn data of the previous round and picks it up again from the experience. Called by AModularExperienceGameModeBase::ResetMatch. */
+	virtual void ResetPawnData();
+
 	//~ Begin APlayerState Interface
 	virtual void PostInitializeComponents() override;
 	//~ End APlayerState Interface
@@ -42,10 +60,23 @@ protected:
 	UPROPERTY(ReplicatedUsing = OnRep_PawnData)
 	TObjectPtr<const UExperiencePawnData> PawnData;
 
+	/**
+	 * If true, a pawn giving up the ability system only cancels its abilities and clears ability input.
+	 * The next pawn takes over the avatar directly and keeps the gameplay cues and tag relationship mapping if it uses the same pawn data.
+	 */
+	UPROPERTY(Config)
+	bool bWarmAbilitySystemHandoff = false;
+
 protected:
 	virtual void OnPawnDataChanged(const UExperiencePawnData* OldPawnData, const UExperiencePawnData* NewPawnData) {}
 	virtual void OnExperienceLoaded(const UExperienceDefinition* CurrentExperience);
 	
 	UFUNCTION()
 	virtual void OnRep_PawnData();
+
+private:
+	/** Pawn that let go of the ability system, and the pawn data it used. */
+	TWeakObjectPtr<const APawn> HandoffPawn;
+	TWeakObjectPtr<const UExperiencePawnData> HandoffPawnData;
+	bool bAbilitySystemHandoffPending = false;
 };
@@ -0,0 +1,65 @@
+// Copyright © 2024 Playton. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "UObject/ObjectKey.h"
+
+class AController;
+
+/**
+ * Number of players the game mode may admit per frame. The budget refills with every new frame it is consumed in.
+ */
+struct GAMEPLAYEXPERIENCESRUNTIME_API FExperienceAdmissionBudget
+{
+public:
+	/** Consumes one admission of the frame. Returns false once MaxPerFrame admissions have been consumed in it. 0 never runs out. */
+	bool TryConsume(int32 MaxPerFrame, uint64 Frame);
+
+	/** Returns the number of admissions consumed in the frame. */
+	int32 GetNumConsumed(uint64 Frame) const { return Frame == LastFrame ? NumConsumed : 0; }
+
+private:
+	uint64 LastFrame = 0;
+	int32 NumConsumed = 0;
+};
+
+/**
+ * Restart attempts of controllers, ordered by the time they are due. Kept as a min-heap so only the due attempts are looked at each frame.
+ * Attempts aren't removed when their retry is rescheduled or dropped, the owner skips the ones that no longer match their retry when popped.
+ */
+class GAMEPLAYEXPERIENCESRUNTIME_API FExperienceRestartRetryQueue
+{
+public:
+	/** A scheduled restart attempt. */
+	struct FAttempt
+	{
+		double AttemptTime = 0.0;
+		uint64 ScheduledFrame = 0;
+		TObjectKey<AController> Controller;
+
+		bool operator<(const FAttempt& Other) const { return AttemptTime < Other.AttemptTime; }
+	};
+
+	/** Schedules an attempt of the controller, due at AttemptTime. */
+	void Schedule(TObjectKey<AController> Controller, double AttemptTime, uint64 Frame);
+
+	/**
+	 * Pops the oldest attempt due at Now. Returns false once no attempt is due anymore.
+	 * Attempts scheduled during Frame, e.g. rescheduled with no delay while the due ones are processed, are held back until EndPass.
+	 */
+	bool PopDue(double Now, uint64 Frame, FAttempt& OutAttempt);
+
+	/** Puts the attempts held back by PopDue back into the queue, for the next frame. */
+	void EndPass();
+
+	/** Drops every attempt. */
+	void Reset();
+
+	/** Returns the number of attempts in the queue, stale ones included. */
+	int32 Num() const { return Heap.Num() + HeldBack.Num(); }
+
+private:
+	TArray<FAttempt> Heap;
+	TArray<FAttempt> HeldBack;
+};
@@ -0,0 +1,7 @@
+// Copyright © 2024 Playton. All Rights Reserved.
+
+#pragma once
+
+#include "Stats/Stats.h"
+
+DECLARE_STATS_GROUP(TEXT("GameplayExperiences"), STATGROUP_GameplayExperiences, STATCAT_Advanced);
@@ -0,0 +1,54 @@
+// Copyright © 2024 Playton. All Rights Reserved.
+
+#pragma once
+
+#include "Input/InputConfig.h"
+#include "UObject/StrongObjectPtr.h"
+
+class UExperiencePawnData;
+struct FExperienceInputConfigEntry;
+
+/**
+ * Input config of a pawn data merged with the input configs contributed by the experience and its action sets.
+ * Built once when the experience loads and immutable afterwards, so pawns can share it and swap it in with a single pointer.
+ * Conflicting bindings are resolved by priority and reported when the table is built.
+ */
+class GAMEPLAYEXPERIENCESRUNTIME_API FExperienceInputConfigTable
+{
+public:
+	/** Merges the input config of the pawn data with the contributed ones that apply to it. The input config of the pawn data has to be loaded already. */
+	static TSharedRef<const FExperienceInputConfigTable> Build(const UExperiencePawnData* PawnData, TConstArrayView<FExperienceInputConfigEntry> Contributions);
+
+	/** Returns the input config of the pawn data the table was built for. */
+	const UInputConfig* GetBaseInputConfig() const { return BaseInputConfig; }
+
+	/** Returns the lookups compiled from the merged bindings. */
+	const FInputConfigLookup& GetLookup() const { return Lookup; }
+
+	/** Returns the merged native bindings, one per tag. */
+	const TArray<FInputConfig_ActionBinding>& GetNativeInputActions() const { return NativeInputActions; }
+
+	/** Returns the merged ability bindings, one per tag. */
+	const TArray<FInputConfig_ActionBinding>& GetAbilityInputActions() const { return AbilityInputActions; }
+
+	/** Returns the input mappings of every merged config, highest priority config first. */
+	const TArray<FInputMappingContextAndPriority>& GetInputMappings() const { return InputMappings; }
+
+	const UInputAction* FindNativeInputActionByTag(const FGameplayTag& Tag) const { return Lookup.FindNativeInputAction(Tag); }
+	const UInputAction* FindAbilityInputActionByTag(const FGameplayTag& Tag) const { return Lookup.FindAbilityInputAction(Tag); }
+	FGameplayTag FindTagForInputAction(const UInputAction* InputAction) const { return Lookup.FindTagForInputAction(InputAction); }
+
+private:
+	const UInputConfig* BaseInputConfig = nullptr;
+
+	/**
+	 * Every config merged into the table. The configs are soft referenced by the pawn data and the experience, so the table keeps them,
+	 * and through them the input actions the bindings point to, from being garbage collected while it is in use.
+	 */
+	TArray<TStrongObjectPtr<const UInputConfig>> SourceConfigs;
+
+	FInputConfigLookup Lookup;
+	TArray<FInputConfig_ActionBinding> NativeInputActions;
+	TArray<FInputConfig_ActionBinding> AbilityInputActions;
+	TArray<FInputMappingContextAndPriority> InputMappings;
+};
@@ -0,0 +1,37 @@
+// Copyright © 2024 Playton. All Rights Reserved.
+
+#pragma once
+
+#include "GameFeatureAction_AddInputMappingContext.h"
+#include "Subsystems/LocalPlayerSubsystem.h"
+
+#include "ExperienceInputMappingSubsystem.generated.h"
+
+class UInputMappingContext;
+
+/**
+ * Keeps track of the input mapping contexts applied for the pawn of a local player.
+ * Possessing or respawning a pawn only adds and removes the contexts that differ from the previous pawn,
+ * instead of clearing every mapping and rebuilding the control mappings from scratch.
+ */
+UCLASS()
+class GAMEPLAYEXPERIENCESRUNTIME_API UExperienceInputMappingSubsystem : public ULocalPlayerSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	/**
+	 * Makes the mappings the ones applied for the player's pawn. Contexts have to be loaded already.
+	 * Only contexts that were added, removed or changed priority are touched, and the control mappings are rebuilt once afterwards.
+	 * Contexts already known to the user settings aren't registered again. Returns the number of contexts that changed.
+	 */
+	int32 ApplyInputMappings(TConstArrayView<FInputMappingContextAndPriority> Mappings);
+
+	/** Forgets about the applied mappings, e.g. after every mapping has been cleared on the enhanced input subsystem. */
+	void ResetAppliedMappings() { AppliedMappings.Reset(); }
+
+private:
+	/** Contexts applied by the last call to ApplyInputMappings, and their priority. */
+	UPROPERTY(Transient)
+	TMap<TObjectPtr<UInputMappingContext>, int32> AppliedMappings;
+};
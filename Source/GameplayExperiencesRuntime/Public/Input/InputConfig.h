@@ -3,6 +3,7 @@
 #pragma once
 
 #include "Engine/DataAsset.h"
+#include "GameFeatureAction_AddInputMappingContext.h"
 #include "GameplayTagContainer.h"
 
 #include "InputConfig.generated.h"
@@ -27,6 +28,47 @@ public:
 	FGameplayTag GameplayTag;
 };
 
+/**
+ * Tag to input action lookups compiled from the bindings of one or more input configs, along with the reverse action to tag index.
+ */
+struct GAMEPLAYEXPERIENCESRUNTIME_API FInputConfigLookup
+{
+public:
+	/** Removes every binding. */
+	void Reset();
+
+	/** Adds the bindings. Tags and actions that already have a binding keep it. */
+	void AddBindings(TConstArrayView<FInputConfig_ActionBinding> NativeBindings, TConstArrayView<FInputConfig_ActionBinding> AbilityBindings);
+
+	const UInputAction* FindNativeInputAction(const FGameplayTag& Tag) const
+	{
+		const UInputAction* const* InputAction = NativeInputActions.Find(Tag);
+		return InputAction ? *InputAction : nullptr;
+	}
+
+	const UInputAction* FindAbilityInputAction(const FGameplayTag& Tag) const
+	{
+		const UInputAction* const* InputAction = AbilityInputActions.Find(Tag);
+		return InputAction ? *InputAction : nullptr;
+	}
+
+	/** Returns the tag the input action is bound to, or an empty tag. */
+	FGameplayTag FindTagForInputAction(const UInputAction* InputAction) const
+	{
+		const FGameplayTag* Tag = InputActionTags.Find(InputAction);
+		return Tag ? *Tag : FGameplayTag();
+	}
+
+	/** Returns the number of tags with a binding. */
+	int32 Num() const { return NativeInputActions.Num() + AbilityInputActions.Num(); }
+
+private:
+	/** The actions are referenced by the input configs the bindings came from. */
+	TMap<FGameplayTag, const UInputAction*> NativeInputActions;
+	TMap<FGameplayTag, const UInputAction*> AbilityInputActions;
+	TMap<const UInputAction*, FGameplayTag> InputActionTags;
+};
+
 /**
  * Non-mutable data asset containing input configuration data.
  * Used to map out certain UInputActions to Gameplay Tags.
@@ -45,6 +87,26 @@ public:
 	/** Retrieves an ability input action by its Gameplay Tag. */
 	const UInputAction* FindAbilityInputActionByTag(const FGameplayTag& Tag, bool bLogNotFound = true) const;
 
+	/** Retrieves the Gameplay Tag an input action is mapped to, native or ability. Returns an empty tag if the action isn't mapped. */
+	FGameplayTag FindTagForInputAction(const UInputAction* InputAction) const;
+
+	/** Retrieves the native input actions of several Gameplay Tags at once. Tags without an input action give a null entry. */
+	void FindNativeInputActionsByTags(TConstArrayView<FGameplayTag> Tags, TArray<const UInputAction*>& OutInputActions) const;
+
+	/** Retrieves the ability input actions of several Gameplay Tags at once. Tags without an input action give a null entry. */
+	void FindAbilityInputActionsByTags(TConstArrayView<FGameplayTag> Tags, TArray<const UInputAction*>& OutInputActions) const;
+
+	/** Returns the lookups compiled from the bindings of this config. */
+	const FInputConfigLookup& GetLookup() const;
+
+	//~ Begin UObject Interface
+	virtual void PostLoad() override;
+#if WITH_EDITOR
+	virtual void PostEditChangeProperty(FPropertyChangedEvent& PropertyChangedEvent) override;
+	virtual void PostEditUndo() override;
+#endif
+	//~ End UObject Interface
+
 public:
 	/** List of native input actions used by the owner. These input actions are mapped to Gameplay Tags but must be manually bound. */
 	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Input", meta = (TitleProperty = "{InputAction} -> {GameplayTag}"))
@@ -54,6 +116,10 @@ public:
 	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Input", meta = (TitleProperty = "{InputAction} -> {GameplayTag}"))
 	TArray<FInputConfig_ActionBinding> AbilityInputActions;
 
+	/** Input mapping contexts added for the owner, in addition to the default input mappings of its hero component. Streamed with the client bundle of the experience. */
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Input")
+	TArray<FInputMappingContextAndPriority> InputMappings;
+
 #if WITH_EDITOR
 	//~ Begin UObject Interface
 	virtual EDataValidationResult IsDataValid(class FDataValidationContext& Context) const override;
@@ -61,5 +127,18 @@ public:
 #endif
 
 private:
-	const UInputAction* FindInputAction(const FGameplayTag& Tag, const TArray<FInputConfig_ActionBinding>& InputActions, bool bLogNotFound) const;
+	/** Compiles the lookups from the bindings. Called on load, or on first use for configs that weren't loaded. */
+	void CompileLookup() const;
+
+	void LogInputActionNotFound(const FGameplayTag& Tag) const;
+
+	mutable FInputConfigLookup Lookup;
+	mutable bool bLookupCompiled = false;
+
+#if !UE_BUILD_SHIPPING
+	friend struct FInputConfigBenchmark;
+
+	/** Linear search over the bindings, the way lookups were done before they were compiled. Kept for benchmarking. */
+	static const UInputAction* FindInputActionLinear(const FGameplayTag& Tag, const TArray<FInputConfig_ActionBinding>& InputActions);
+#endif
 };
@@ -0,0 +1,97 @@
+// Copyright © 2024 Playton. All Rights Reserved.
+
+#pragma once
+
+#include "Containers/Ticker.h"
+#include "UObject/Object.h"
+
+#include "ExperienceMatchAssignmentProvider.generated.h"
+
+/**
+ * Match assignment handed to a server by matchmaking.
+ */
+USTRUCT(BlueprintType)
+struct FExperienceMatchAssignment
+{
+	GENERATED_BODY()
+
+public:
+	/** The experience the server should host. */
+	UPROPERTY(BlueprintReadOnly, Category = "Matchmaking")
+	FPrimaryAssetId ExperienceId;
+
+	/** Identifier of the match, as given by matchmaking. */
+	UPROPERTY(BlueprintReadOnly, Category = "Matchmaking")
+	FString MatchId;
+
+	/** Additional URL options for the match, merged into the options of the game mode that claims the assignment. */
+	UPROPERTY(BlueprintReadOnly, Category = "Matchmaking")
+	FString Options;
+};
+
+DECLARE_MULTICAST_DELEGATE_OneParam(FOnExperienceMatchAssignmentReceived, const FExperienceMatchAssignment& /*Assignment*/);
+
+/**
+ * Pluggable source of match assignments for dedicated servers.
+ * Projects subclass this to talk to their matchmaking backend and call ReceiveAssignment every time an assignment arrives.
+ */
+UCLASS(Abstract, Config = Game)
+class GAMEPLAYEXPERIENCESRUNTIME_API UExperienceMatchAssignmentProvider : public UObject
+{
+	GENERATED_BODY()
+
+public:
+	UExperienceMatchAssignmentProvider();
+
+	/** Starts waiting for assignments. Providers keep listening after an assignment, a server hosts one match after the other. */
+	virtual void StartListening() {}
+
+	/** Stops waiting for assignments. */
+	virtual void StopListening() {}
+
+	/** Delegate called when an assignment has been received. */
+	FOnExperienceMatchAssignmentReceived OnAssignmentReceived;
+
+protected:
+	/** Should be called by implementations once an assignment has been received. */
+	void ReceiveAssignment(const FExperienceMatchAssignment& Assignment);
+};
+
+/**
+ * Local stand-in for a matchmaking backend that reads the assignment from a file.
+ * The file contains "Key=Value" lines for Experience, MatchId and Options and is polled while listening, every rewrite of it is a new assignment.
+ * The path can be overridden with -MatchAssignmentFile=<Path> on the command line.
+ */
+UCLASS(Config = Game)
+class GAMEPLAYEXPERIENCESRUNTIME_API UExperienceFileMatchAssignmentProvider : public UExperienceMatchAssignmentProvider
+{
+	GENERATED_BODY()
+
+public:
+	UExperienceFileMatchAssignmentProvider();
+
+	//~ Begin UExperienceMatchAssignmentProvider Interface
+	virtual void StartListening() override;
+	virtual void StopListening() override;
+	//~ End UExperienceMatchAssignmentProvider Interface
+
+protected:
+	bool PollAssignmentFile(float DeltaTime);
+	bool ParseAssignment(const FString& Contents, FExperienceMatchAssignment& OutAssignment) const;
+
+protected:
+	/** Path of the assignment file, relative paths are relative to the project saved directory. */
+	UPROPERTY(Config)
+	FString AssignmentFilePath;
+
+	/** Time in seconds between two checks of the assignment file. */
+	UPROPERTY(Config)
+	float PollInterval = 0.25f;
+
+private:
+	FString ResolvedFilePath;
+	FTSTicker::FDelegateHandle PollHandle;
+
+	/** Time stamp of the file the last assignment was read from. */
+	FDateTime LastAssignmentTimeStamp = FDateTime::MinValue();
+};
@@ -3,12 +3,14 @@
 #pragma once
 
 #include "ModularGameMode.h"
+#include "GameFramework/ExperienceSpawnScheduling.h"
 
 #include "ModularExperienceGameMode.generated.h"
 
 struct FGameFeaturePluginURL;
 class UExperienceDefinition;
 class AActor;
+class AAIController;
 class AController;
 class AGameModeBase;
 class APawn;
@@ -25,6 +27,73 @@ struct FPrimaryAssetId;
  */
 DECLARE_MULTICAST_DELEGATE_TwoParams(FOnPlayerInitialized, AGameModeBase* /*GameMode*/, AController* /*NewPlayer*/);
 
+/** Called after the match has been reset in place. */
+DECLARE_MULTICAST_DELEGATE_OneParam(FOnMatchReset, AGameModeBase* /*GameMode*/);
+
+/**
+ * Snapshot of the player admission pipeline of the game mode.
+ */
+USTRUCT(BlueprintType)
+struct FExperienceAdmissionStats
+{
+	GENERATED_BODY()
+
+public:
+	/** Number of players currently waiting to be admitted. */
+	UPROPERTY(BlueprintReadOnly, Category = "Admission")
+	int32 QueueLength = 0;
+
+	/** Highest number of players that were waiting at the same time. */
+	UPROPERTY(BlueprintReadOnly, Category = "Admission")
+	int32 PeakQueueLength = 0;
+
+	/** Number of players admitted so far. */
+	UPROPERTY(BlueprintReadOnly, Category = "Admission")
+	int32 NumAdmitted = 0;
+
+	/** Number of players that received a pawn after being admitted. */
+	UPROPERTY(BlueprintReadOnly, Category = "Admission")
+	int32 NumSpawned = 0;
+
+	/** Time in seconds between the player starting and receiving a pawn, for the last spawned player. */
+	UPROPERTY(BlueprintReadOnly, Category = "Admission")
+	float LastTimeToPawn = 0.f;
+
+	/** Average time in seconds between the player starting and receiving a pawn. */
+	UPROPERTY(BlueprintReadOnly, Category = "Admission")
+	float AverageTimeToPawn = 0.f;
+
+	/** Longest time in seconds between the player starting and receiving a pawn. */
+	UPROPERTY(BlueprintReadOnly, Category = "Admission")
+	float MaxTimeToPawn = 0.f;
+};
+
+/**
+ * Counters of the restart retry scheduler of the game mode.
+ */
+USTRUCT(BlueprintType)
+struct FExperienceRestartStats
+{
+	GENERATED_BODY()
+
+public:
+	/** Number of restart attempts that failed to spawn a pawn. */
+	UPROPERTY(BlueprintReadOnly, Category = "Restart")
+	int32 NumFailedRestarts = 0;
+
+	/** Number of retries performed by the scheduler. */
+	UPROPERTY(BlueprintReadOnly, Category = "Restart")
+	int32 NumRetries = 0;
+
+	/** Number of controllers that were given up on after reaching the retry limit. */
+	UPROPERTY(BlueprintReadOnly, Category = "Restart")
+	int32 NumAbandoned = 0;
+
+	/** Number of controllers currently waiting for a retry. */
+	UPROPERTY(BlueprintReadOnly, Category = "Restart")
+	int32 NumPendingRetries = 0;
+};
+
 /**
  * Game mode for a modular experience. 
  */
@@ -36,7 +105,7 @@ class GAMEPLAYEXPERIENCESRUNTIME_API AModularExperienceGameModeBase : public AMo
 public:
 	AModularExperienceGameModeBase(const FObjectInitializer& ObjectInitializer = FObjectInitializer::Get());
 
-	/** Retrieves the pawn data for the given controller. */
+	/** Retrieves the pawn data for the given controller. Controllers that aren't player controllers get the bot pawn data of the experience, if it has one. */
 	UFUNCTION(BlueprintCallable, Category = Experience)
 	const UExperiencePawnData* GetPawnDataForController(const AController* InController) const;
 
@@ -47,11 +116,54 @@ public:
 	UFUNCTION(BlueprintCallable, Category = Experience)
 	virtual void RequestPlayerRestartNextFrame(AController* Controller, bool bForceReset = false);
 
+	/** Returns a snapshot of the player admission pipeline. */
+	UFUNCTION(BlueprintCallable, Category = Experience)
+	FExperienceAdmissionStats GetAdmissionStats() const;
+
+	/** Returns the counters of the restart retry scheduler. */
+	UFUNCTION(BlueprintCallable, Category = Experience)
+	FExperienceRestartStats GetRestartStats() const;
+
+	/**
+	 * Resets the match in place, keeping the experience, its plugins and bundles loaded.
+	 * Resets the player states, destroys (or recycles) the pawns, re-runs the resettable actions and restarts every player.
+	 * Players are restarted once every resettable action has been activated again, OnMatchReset is broadcast then.
+	 * @return False if the experience hasn't loaded yet or a reset is still in progress.
+	 */
+	UFUNCTION(BlueprintCallable, BlueprintAuthorityOnly, Category = Experience)
+	virtual bool ResetMatch();
+
+	/**
+	 * Spawns bots until the match has the given number of them. Bots are spawned in batches of MaxBotSpawnsPerFrame.
+	 * Called with the bot fill settings of the experience once it has loaded.
+	 */
+	UFUNCTION(BlueprintCallable, BlueprintAuthorityOnly, Category = Experience)
+	void RequestBotFill(int32 NumBots);
+
+	/** Returns the number of bots spawned by the bot fill. */
+	UFUNCTION(BlueprintCallable, Category = Experience)
+	int32 GetNumBots() const;
+
 	/** Toggles an existing game feature plugin and activates or deactivates it. */
 	UFUNCTION(BlueprintCallable, Category = Experience)
 	virtual void ToggleGameFeaturePlugin(FGameFeaturePluginURL& PluginURL, bool bEnable);
 
+	/**
+	 * Holds back the unloading of disabled plugins (and the garbage collection that comes with it), e.g. during a round.
+	 * Only used when bCoalescePluginUnloads is set. Releasing the hold purges everything that queued up in the meantime. Unloads still pending at the end of play are dropped.
+	 */
+	UFUNCTION(BlueprintCallable, Category = Experience)
+	void SetPluginUnloadPurgeHeld(bool bHeld);
+
+	/** Unloads every pending plugin at the start of the next world tick, unless the purge is held. Use it at a quiet moment, e.g. between rounds. */
+	UFUNCTION(BlueprintCallable, Category = Experience)
+	void FlushPendingPluginUnloads();
+
 public:
+	//~ Begin AActor Interface
+	virtual void Tick(float DeltaSeconds) override;
+	//~ End AActor Interface
+
 	//~ Begin AGameModeBase Interface
 	virtual void InitGame(const FString& MapName, const FString& Options, FString& ErrorMessage) override;
 	virtual void InitGameState() override;
@@ -67,6 +179,7 @@ public:
 	virtual bool UpdatePlayerStartSpot(AController* Player, const FString& Portal, FString& OutErrorMessage) override;
 	virtual void GenericPlayerInitialization(AController* C) override;
 	virtual void FailedToRestartPlayer(AController* NewPlayer) override;
+	virtual void Logout(AController* Exiting) override;
 
 	virtual void StartPlay() override;
 	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
@@ -75,9 +188,15 @@ public:
 	/** Agnostic version of PlayerCanRestart that can be used for both player and AI controllers. */
 	virtual bool ControllerCanRestart(AController* Controller);
 
+	/** Returns the team id used to filter player starts for the given controller. */
+	virtual uint8 GetPlayerStartTeamId(const AController* Controller) const;
+
 	/** Delegate called when a player or bot joins the game. */
 	FOnPlayerInitialized OnGameModePlayerInitialized;
 
+	/** Delegate called after the match has been reset with ResetMatch. */
+	FOnMatchReset OnMatchReset;
+
 protected:
 	void OnExperienceLoaded(const UExperienceDefinition* CurrentExperience);
 	bool IsExperienceLoaded() const;
@@ -88,8 +207,74 @@ protected:
 
 	virtual bool TryDedicatedServerLogin();
 
+	/** Called when a matchmaking assignment arrives after the game mode started waiting for one. */
+	void OnMatchAssignmentReceived(const struct FExperienceMatchAssignment& Assignment);
+
+	/** Merges the URL options of the claimed matchmaking assignment into OptionsString. */
+	virtual void ApplyMatchAssignmentOptions(const FString& AssignmentOptions);
+
 	virtual void UnloadPluginsPreWorldTick(UWorld* World, ELevelTick TickType, float DeltaSeconds);
 
+	/** Binds UnloadPluginsPreWorldTick so the pending plugins are unloaded at the start of the next world tick. */
+	void SchedulePluginUnloadPurge();
+
+	/** Unloads every plugin in PluginsToUnloadPreWorldTick right away, followed by a single garbage collection when unloads are coalesced. */
+	void UnloadPendingPlugins();
+
+	/** Adds a player to the back of the admission queue, unless it is already waiting. */
+	void EnqueueAdmission(APlayerController* NewPlayer);
+
+	/** Admits queued players in arrival order, within the per-frame budget. */
+	void ProcessAdmissionQueue();
+
+	/** Consumes one admission from the budget of the current frame. Returns false if the budget is exhausted. */
+	bool TryConsumeAdmissionBudget();
+
+	/** Starts the player for real, restarting it if it can. */
+	virtual void AdmitPlayer(APlayerController* NewPlayer);
+
+	/** Stops measuring the time to pawn of a controller that won't receive a pawn, e.g. a player that became a spectator. */
+	void ForgetTimeToPawn(AController* Controller);
+
+	/** Drops the time to pawn of controllers that are gone, were possessed outside of a restart, or became spectators. */
+	void PruneTimeToPawn();
+
+	/** Returns true if there are players waiting to be admitted. */
+	bool HasPendingAdmissions() const { return QueuedAdmissions.Num() > 0; }
+
+	/** Schedules another restart attempt for a controller that failed to restart, backing off exponentially per controller. */
+	void ScheduleRestartRetry(AController* Controller);
+
+	/** Retries every due restart in one batched pass, within the per-frame budget. */
+	void ProcessRestartRetries();
+
+	/** Spawns and restarts a single bot. */
+	virtual AAIController* SpawnBot(int32 BotIndex);
+
+	/** Spawns the next batch of bots, within the per-frame budget. */
+	void ProcessBotFill();
+
+	/** Restarts the players of a match reset once its resettable actions have been activated again. */
+	void FinishResetMatch(TArray<TWeakObjectPtr<AController>> ResetControllers, TArray<TWeakObjectPtr<AController>> RecycledControllers, double StartTime);
+
+	/**
+	 * Resets a pawn kept across a match reset, including its ability system, and moves it to a new start spot.
+	 * Returns false if the pawn can't be reset cleanly, it is then destroyed and respawned instead.
+	 */
+	virtual bool RecyclePawn(AController* Controller, APawn* Pawn);
+
+	/** Returns true if the game mode has queued work that needs it to keep ticking. */
+	virtual bool HasPendingTickWork() const;
+
+	/** Returns true once level streaming and the experience load allow the match to start. */
+	virtual bool IsStartPlayGateOpen() const;
+
+	/** Returns true if the experience allows the match to start, always the case unless bStartPlayWaitsForExperience is set. */
+	virtual bool IsExperienceReadyForStartPlay() const;
+
+	/** Polls the start play gate every frame until it opens, then starts play. */
+	void PollStartPlayGate();
+
 	/** Override to return the experience to load from the developer settings. (will be project-specific) */
 	virtual FPrimaryAssetId GetExperienceFromDeveloperSettings() const { return FPrimaryAssetId(); }
 
@@ -108,8 +293,130 @@ protected:
 	UPROPERTY(Config, EditDefaultsOnly, BlueprintReadOnly, Category = Classes, AdvancedDisplay, meta = (AllowedTypes = "ExperienceDefinition"))
 	FPrimaryAssetId DefaultExperienceOverride;
 
+	/** If true, StartPlay also waits for the match assignment and the experience to finish loading, not only for level streaming. */
+	UPROPERTY(Config, EditDefaultsOnly, Category = "Experience|Start Play")
+	bool bStartPlayWaitsForExperience = false;
+
+	/**
+	 * Time in seconds StartPlay waits asynchronously before falling back to blocking on level streaming. 0 waits forever.
+	 * The experience is still waited for after the timeout.
+	 */
+	UPROPERTY(Config, EditDefaultsOnly, Category = "Experience|Start Play", meta = (ClampMin = 0, Units = "s"))
+	float StartPlayGateTimeout = 60.f;
+
+	/** If true, disabled plugins are deactivated right away but their unloads are coalesced and performed together at a scheduled point. */
+	UPROPERTY(Config, EditDefaultsOnly, Category = "Experience|Plugins")
+	bool bCoalescePluginUnloads = false;
+
+	/** Time in seconds plugin unloads are collected before being purged together. */
+	UPROPERTY(Config, EditDefaultsOnly, Category = "Experience|Plugins", meta = (ClampMin = 0, Units = "s", EditCondition = "bCoalescePluginUnloads"))
+	float PluginUnloadCoalesceWindow = 2.f;
+
+	/**
+	 * Maximum number of players admitted (started and restarted) per frame, in arrival order.
+	 * Smooths out join storms, e.g. a full lobby joining while the experience loads. 0 admits everyone right away.
+	 */
+	UPROPERTY(Config, EditDefaultsOnly, Category = "Experience|Admission", meta = (ClampMin = 0))
+	int32 MaxAdmissionsPerFrame = 0;
+
+	/** Delay in seconds before the first restart retry of a controller. Doubles with every further failure. */
+	UPROPERTY(Config, EditDefaultsOnly, Category = "Experience|Restart", meta = (ClampMin = 0, Units = "s"))
+	float RestartRetryBaseDelay = 0.1f;
+
+	/** Maximum delay in seconds between two restart retries of a controller. */
+	UPROPERTY(Config, EditDefaultsOnly, Category = "Experience|Restart", meta = (ClampMin = 0, Units = "s"))
+	float RestartRetryMaxDelay = 5.f;
+
+	/** Number of failed restarts after which a controller is given up on. 0 retries forever. */
+	UPROPERTY(Config, EditDefaultsOnly, Category = "Experience|Restart", meta = (ClampMin = 0))
+	int32 MaxRestartRetries = 0;
+
+	/** Maximum number of restart retries performed per frame. 0 retries every due controller. */
+	UPROPERTY(Config, EditDefaultsOnly, Category = "Experience|Restart", meta = (ClampMin = 0))
+	int32 MaxRestartRetriesPerFrame = 4;
+
+	/** If true, bots whose restart failed are retried like players. Otherwise they stay without a pawn, as only players are restarted again. */
+	UPROPERTY(Config, EditDefaultsOnly, Category = "Experience|Restart")
+	bool bRetryBotRestarts = false;
+
+	/** If true, ResetMatch keeps pawns whose pawn data doesn't change, resets them and moves them to a new start, rather than destroying them. */
+	UPROPERTY(Config, EditDefaultsOnly, Category = "Experience|Reset")
+	bool bRecyclePawnsOnMatchReset = false;
+
+	/** Maximum number of bots spawned per frame by the bot fill. */
+	UPROPERTY(Config, EditDefaultsOnly, Category = "Experience|Bots", meta = (ClampMin = 1))
+	int32 MaxBotSpawnsPerFrame = 4;
+
 	/** Cached off set of plugin urls that should be unloaded next tick */
 	TSet<FString> PluginsToUnloadPreWorldTick;
+
+	/** Plugins enabled with ToggleGameFeaturePlugin, whose activation this game mode requested. */
+	TSet<FString> EnabledPluginURLs;
+
+private:
+	/** True once OnMatchAssignmentGiven has run, with or without a valid experience. */
+	bool bMatchAssignmentGiven = false;
+
+	/** Real time at which StartPlay started waiting on the gate. */
+	double StartPlayGateBeginTime = 0.0;
+
+	FTimerHandle StartPlayGateTimerHandle;
+
+	/** True once the StartPlay gate timed out and level streaming was blocked on. */
+	bool bStartPlayGateTimedOut = false;
+
+	/** Timer closing the current plugin unload coalescing window. */
+	FTimerHandle PluginUnloadWindowHandle;
+
+	/** True while SetPluginUnloadPurgeHeld holds back plugin unloads. */
+	bool bPluginUnloadPurgeHeld = false;
+
+	/** A player waiting to be admitted. */
+	struct FPendingAdmission
+	{
+		TWeakObjectPtr<APlayerController> Controller;
+		double EnqueueTime = 0.0;
+	};
+
+	/** Players waiting to be admitted, in arrival order. Entries before AdmissionQueueHead have been consumed. */
+	TArray<FPendingAdmission> AdmissionQueue;
+	int32 AdmissionQueueHead = 0;
+
+	/** Players currently in the admission queue. */
+	TSet<TObjectKey<APlayerController>> QueuedAdmissions;
+
+	/** Time at which each admitted player started waiting, until it receives a pawn. */
+	TMap<TObjectKey<AController>, double> PendingTimeToPawn;
+
+	FExperienceAdmissionBudget AdmissionBudget;
+
+	FExperienceAdmissionStats AdmissionStats;
+	double TotalTimeToPawn = 0.0;
+
+	/** A controller waiting to retry its restart. */
+	struct FPendingRestartRetry
+	{
+		TWeakObjectPtr<AController> Controller;
+		double NextAttemptTime = 0.0;
+		int32 NumFailures = 0;
+	};
+
+	/** Controllers waiting to retry their restart. */
+	TMap<TObjectKey<AController>, FPendingRestartRetry> PendingRestartRetries;
+
+	/** Scheduled restart attempts. An attempt is stale once the controller's retry has been rescheduled or removed. */
+	FExperienceRestartRetryQueue RestartRetryQueue;
+
+	FExperienceRestartStats RestartStats;
+
+	/** Bots spawned by the bot fill. */
+	TArray<TWeakObjectPtr<AAIController>> SpawnedBots;
+
+	/** Number of bots the bot fill is aiming for. */
+	int32 NumBotsWanted = 0;
+
+	/** Handle of the pending wait for a matchmaking assignment. */
+	FDelegateHandle MatchAssignmentHandle;
 };
 
 /**